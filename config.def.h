@@ -79,6 +79,11 @@ wchar_t *kbds_sdelim = L"!\"#$%&'()*+,-./:;<=>?@[\\]^`{|}~ ";
 wchar_t *kbds_ldelim = L" ";
 #endif // KEYBOARDSELECT_PATCH
 
+#if KEYBOARDSELECT_PATCH && REFLOW_PATCH && INDEXED_SEARCH_PATCH
+/* number of history lines searched at a time between frames in keyboard select mode */
+static unsigned int searchslice = 2000;
+#endif // INDEXED_SEARCH_PATCH
+
 /* selection timeouts (in milliseconds) */
 static unsigned int doubleclicktimeout = 300;
 static unsigned int tripleclicktimeout = 600;
@@ -99,6 +104,48 @@ int allowwindowops = 0;
 static double minlatency = 2;
 static double maxlatency = 33;
 
+#if TTY_RINGBUFFER_PATCH || TTY_THREAD_PATCH
+/*
+ * size in bytes of the buffer that the output of the shell is read into, this
+ * must be a power of two
+ */
+unsigned int ttyringsize = 1 << 20;
+#endif // TTY_RINGBUFFER_PATCH
+
+#if STRSTREAM_PATCH
+/*
+ * string sequences (OSC, DCS, APC and PM) longer than this many bytes are
+ * discarded, e.g. an OSC 52 clipboard push; 0 means no limit
+ */
+unsigned int strmaxlen = 64 << 20;
+#endif // STRSTREAM_PATCH
+
+#if TTY_WRITEQUEUE_PATCH
+/*
+ * how many bytes of input may be queued up for the shell, e.g. when pasting,
+ * before st stops and waits for the shell to read them
+ */
+unsigned int ttywritemax = 1 << 20;
+#endif // TTY_WRITEQUEUE_PATCH
+
+#if DYNAMIC_HISTORY_PATCH
+/*
+ * number of lines kept in the scrollback history, and the most memory in MiB
+ * the history may take up; 0 means no limit. The history grows as lines
+ * scroll off the screen until either limit is reached.
+ */
+unsigned int histsize = 2000;
+unsigned int histmemory = 0;
+#endif // DYNAMIC_HISTORY_PATCH
+
+#if INCREMENTAL_REFLOW_PATCH
+/*
+ * number of old history lines reflowed at a time between frames after the
+ * window has been resized
+ */
+static unsigned int reflowslice = 1000;
+#endif // INCREMENTAL_REFLOW_PATCH
+
 #if SYNC_PATCH
 /*
  * Synchronized-Update timeout in ms
@@ -113,6 +160,22 @@ static uint su_timeout = 200;
  */
 static unsigned int blinktimeout = 800;
 
+#if COALESCE_RESIZE_PATCH
+/*
+ * while the window is being resized, wait until its size has not changed for
+ * resizedelay ms before resizing the terminal
+ */
+static unsigned int resizedelay = 50;
+#endif // COALESCE_RESIZE_PATCH
+
+#if STREAMING_PASTE_PATCH
+/*
+ * give up on a large (INCR) paste when the selection owner has not sent the
+ * next chunk for pastetimeout ms
+ */
+static unsigned int pastetimeout = 5000;
+#endif // STREAMING_PASTE_PATCH
+
 /*
  * thickness of underline and bar cursors
  */
@@ -336,8 +399,21 @@ ResourcePref resources[] = {
 		{ "minlatency",   INTEGER, &minlatency },
 		{ "maxlatency",   INTEGER, &maxlatency },
 		{ "blinktimeout", INTEGER, &blinktimeout },
+		#if COALESCE_RESIZE_PATCH
+		{ "resizedelay",  INTEGER, &resizedelay },
+		#endif // COALESCE_RESIZE_PATCH
+		#if STREAMING_PASTE_PATCH
+		{ "pastetimeout", INTEGER, &pastetimeout },
+		#endif // STREAMING_PASTE_PATCH
 		{ "bellvolume",   INTEGER, &bellvolume },
 		{ "tabspaces",    INTEGER, &tabspaces },
+		#if DYNAMIC_HISTORY_PATCH
+		{ "histsize",     INTEGER, &histsize },
+		{ "histmemory",   INTEGER, &histmemory },
+		#endif // DYNAMIC_HISTORY_PATCH
+		#if INCREMENTAL_REFLOW_PATCH
+		{ "reflowslice",  INTEGER, &reflowslice },
+		#endif // INCREMENTAL_REFLOW_PATCH
 		#if RELATIVEBORDER_PATCH
 		{ "borderperc",   INTEGER, &borderperc },
 		#else
@@ -355,6 +431,9 @@ ResourcePref resources[] = {
 		{ "highlightfg",  INTEGER, &highlightfg },
 		{ "highlightbg",  INTEGER, &highlightbg },
 		#endif // KEYBOARDSELECT_PATCH
+		#if KEYBOARDSELECT_PATCH && REFLOW_PATCH && INDEXED_SEARCH_PATCH
+		{ "searchslice",  INTEGER, &searchslice },
+		#endif // INDEXED_SEARCH_PATCH
 };
 #endif // XRESOURCES_PATCH
 
@@ -30,9 +30,15 @@ PKG_CONFIG = pkg-config
 #SIXEL_C = sixel.c sixel_hls.c
 #SIXEL_LIBS = `$(PKG_CONFIG) --libs imlib2`
 
+# Unicode Character Database for regenerating the width table / UNICODE_WIDTH_PATCH
+UCD = /usr/share/unicode
+
 # Uncomment for the netwmicon patch / NETWMICON_PATCH
 #NETWMICON_LIBS = `$(PKG_CONFIG) --libs gdlib`
 
+# Uncomment for the tty reader thread patch / TTY_THREAD_PATCH
+#PTHREAD_LIBS = -lpthread
+
 # includes and libs, uncomment harfbuzz for the ligatures patch
 INCS = -I$(X11INC) \
        `$(PKG_CONFIG) --cflags fontconfig` \
@@ -42,7 +48,8 @@ LIBS = -L$(X11LIB) -lm -lX11 -lutil -lXft ${SIXEL_LIBS} ${XRENDER} ${XCURSOR}\
        `$(PKG_CONFIG) --libs fontconfig` \
        `$(PKG_CONFIG) --libs freetype2` \
        $(LIGATURES_LIBS) \
-       $(NETWMICON_LIBS)
+       $(NETWMICON_LIBS) \
+       $(PTHREAD_LIBS)
 
 # flags
 STCPPFLAGS = -DVERSION=\"$(VERSION)\" -DICON=\"$(ICONPREFIX)/$(ICONNAME)\" -D_XOPEN_SOURCE=600
@@ -0,0 +1,131 @@
+# Extracts the settings that st.c reads from config.h, for nullwin.c.
+#
+# usage: awk -f configglobals.awk config.h > configglobals.h
+#
+# nullwin.c can not include config.h itself, as the shortcut and key tables
+# refer to functions that only x.c has. The settings that st.c uses are the
+# top level definitions that are not static, so those are kept along with the
+# preprocessor lines around them.
+#
+# config.h is read as a list of top level statements, each ending in a ';' or,
+# for a function body, in a '}'. A statement may span lines. It is
+#
+#  - dropped if it starts with static, typedef, enum, struct, union or extern,
+#    if it has braces (the tables and any functions) or if it is a prototype,
+#  - copied as it is otherwise, which are the definitions st.c reads.
+#
+# Preprocessor lines between statements are copied, and may be continued with
+# a backslash. Inside a dropped statement they are dropped along with it, as
+# long as each #if there ends within the statement. Anything else stops the
+# script with an error rather than leave nullwin.o to fail later on:
+#
+#  - a preprocessor line within a definition that is copied,
+#  - an #else, #elif or #endif within a statement that belongs to an #if
+#    outside of it,
+#  - a statement, comment, brace or #if that is still open at the end.
+
+BEGIN {
+	print "/* Generated from config.h by configglobals.awk, do not edit. */";
+}
+
+function fail(msg) {
+	printf("configglobals.awk: %s:%d: %s\n", FILENAME, FNR, msg) > "/dev/stderr";
+	failed = 1;
+	exit 1;
+}
+
+function finish() {
+	sub(/^[ \t]+/, "", stmtcode);
+	if (stmtcode !~ /^(static|typedef|enum|struct|union|extern)[ \t]/ &&
+	    stmtcode !~ /{/ && (stmtcode ~ /=/ || stmtcode !~ /\(/))
+		print stmt;
+	stmt = stmtcode = "";
+	instmt = 0;
+}
+
+{
+	# strip comments, which can span lines, and string and character literals,
+	# which can hold braces and semicolons
+	rest = $0;
+	code = "";
+	while (rest != "") {
+		if (incomment) {
+			if (!(i = index(rest, "*/")))
+				break;
+			rest = substr(rest, i + 2);
+			incomment = 0;
+		} else if ((i = index(rest, "/*"))) {
+			code = code substr(rest, 1, i - 1);
+			rest = substr(rest, i + 2);
+			incomment = 1;
+		} else {
+			code = code rest;
+			rest = "";
+		}
+	}
+	gsub(/"([^"\\]|\\.)*"/, "\"\"", code);
+	gsub(/'([^'\\]|\\.)*'/, "''", code);
+	sub(/\/\/.*/, "", code);
+}
+
+cont {
+	if (!instmt)
+		print;
+	cont = /\\$/;
+	next;
+}
+
+code ~ /^[ \t]*#/ {
+	directive = code;
+	sub(/^[ \t]*#[ \t]*/, "", directive);
+	sub(/[^a-z].*/, "", directive);
+	cont = /\\$/;
+	if (!instmt) {
+		if (directive ~ /^if/)
+			ifdepth++;
+		else if (directive == "endif")
+			ifdepth--;
+		print;
+		next;
+	}
+	if (stmtcode !~ /{/)
+		fail("preprocessor line within a definition");
+	if (directive ~ /^if/)
+		stmtif++;
+	else if (directive ~ /^(else|elif|endif)$/ && !stmtif)
+		fail("#" directive " of an #if outside of the statement");
+	else if (directive == "endif")
+		stmtif--;
+	next;
+}
+
+!instmt && code ~ /^[ \t]*$/ {
+	next;
+}
+
+{
+	if (!instmt) {
+		instmt = 1;
+		stmtif = 0;
+		stmt = $0;
+	} else {
+		stmt = stmt "\n" $0;
+	}
+	stmtcode = stmtcode " " code;
+	depth += gsub(/{/, "{", code) - gsub(/}/, "}", code);
+	if (depth < 0)
+		fail("unbalanced '}'");
+	if (depth == 0 && (code ~ /;[ \t]*$/ || (code ~ /}[ \t]*$/ && stmtcode !~ /=/)))
+		finish();
+}
+
+END {
+	if (failed)
+		exit 1;
+	if (incomment)
+		fail("comment not closed");
+	if (instmt)
+		fail("statement not ended");
+	if (ifdepth)
+		fail("#if not closed");
+}
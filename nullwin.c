@@ -0,0 +1,65 @@
+/* See LICENSE for license details. */
+
+/*
+ * A window backend that does nothing, for linking the terminal emulation
+ * without X. Together with st.o this makes up libst-term.a, built with
+ * "make libst-term.a". The X headers are still needed to compile, and
+ * patches that call Xlib from st.c (e.g. openurlonclick) still need -lX11.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <wchar.h>
+
+#include "st.h"
+#include "win.h"
+
+/* globals otherwise defined in x.c */
+Term term;
+DC dc;
+XWindow xw;
+XSelection xsel;
+TermWindow win;
+char *argv0;
+
+/* the settings from config.h, see configglobals.awk */
+#include "configglobals.h"
+
+void xbell(void) {}
+void xclipcopy(void) {}
+#if LIGATURES_PATCH
+void xdrawcursor(int cx, int cy, Glyph g, int ox, int oy, Glyph og, Line line, int len) {}
+#else
+void xdrawcursor(int cx, int cy, Glyph g, int ox, int oy, Glyph og) {}
+#endif // LIGATURES_PATCH
+void xdrawline(Line line, int x1, int y1, int x2) {}
+void xfinishdraw(void) {}
+void xloadcols(void) {}
+int xsetcolorname(int x, const char *name) { return 1; }
+int xgetcolor(int x, unsigned char *r, unsigned char *g, unsigned char *b) { return 1; }
+void xseticontitle(char *p) {}
+#if CSI_22_23_PATCH
+void xfreetitlestack(void) {}
+void xsettitle(char *p, int pop) {}
+void xpushtitle(void) {}
+#else
+void xsettitle(char *p) {}
+#endif // CSI_22_23_PATCH
+int xsetcursor(int cursor) { return 0; }
+void xsetmode(int set, unsigned int flags) { MODBIT(win.mode, set, flags); }
+void xsetpointermotion(int set) {}
+void xsetsel(char *str) { free(str); }
+int xstartdraw(void) { return 0; }
+void xximspot(int x, int y) {}
+void xclearwin(void) {}
+#if SCROLL_BLIT_PATCH
+int xscroll(int top, int bot, int n) { return 0; }
+#endif // SCROLL_BLIT_PATCH
+#if REFLOW_PATCH && KEYBOARDSELECT_PATCH
+void xdrawglyph(Glyph g, int x, int y) {}
+#endif // KEYBOARDSELECT_PATCH
+#if BOXDRAW_PATCH
+int isboxdraw(Rune u) { return 0; }
+#endif // BOXDRAW_PATCH
+#if KEYBOARDSELECT_PATCH && !REFLOW_PATCH
+void toggle_winmode(int flag) { win.mode ^= flag; }
+#endif // KEYBOARDSELECT_PATCH
@@ -0,0 +1,100 @@
+/*
+ * Writes a run of printable ASCII characters directly into the current line.
+ *
+ * This does the same as calling tputc() for every character in the run, but
+ * the sequence state, insert mode, selection and wrap handling is checked once
+ * per run rather than once per character. The run stops at the first non
+ * printable byte or at the right margin, whichever comes first, and the
+ * remaining input is left for tputc() to handle.
+ *
+ * Returns the number of bytes written, or 0 if the fast path does not apply.
+ */
+int
+tputascii(const char *s, int len)
+{
+	int i, n, x = term.c.x, y = term.c.y;
+	uint32_t mode, pmode;
+	Glyph g, *line;
+
+	if (term.esc || IS_SET(MODE_PRINT|MODE_INSERT) ||
+	    (term.c.state & CURSOR_WRAPNEXT) ||
+	    term.trantbl[term.charset] == CS_GRAPHIC0)
+		return 0;
+
+	for (n = 0; n < len && n < term.col - x &&
+	     BETWEEN((uchar)s[n], 0x20, 0x7e); n++)
+		;
+	if (!n)
+		return 0;
+
+	if (sel.ob.x != -1) {
+		#if REFLOW_PATCH
+		/* regionselected() takes relative coordinates */
+		if (regionselected(x, y + term.scr, x + n - 1, y + term.scr))
+			selclear();
+		#else
+		for (i = x; i < x + n; i++) {
+			if (selected(i, y)) {
+				selclear();
+				break;
+			}
+		}
+		#endif // REFLOW_PATCH
+	}
+
+	line = term.line[y];
+	g = term.c.attr;
+	#if REFLOW_PATCH
+	g.mode |= ATTR_SET;
+	#endif // REFLOW_PATCH
+
+	#if DIRTY_SPAN_PATCH
+	int minx = (line[x].mode & ATTR_WDUMMY) ? x-1 : x;
+	#endif // DIRTY_SPAN_PATCH
+
+	/* clear wide characters that are partially overwritten, this does the
+	 * same as tsetchar() does for each cell, in the same order */
+	if (line[x].mode & ATTR_WDUMMY) {
+		line[x-1].u = ' ';
+		line[x-1].mode &= ~ATTR_WIDE;
+	}
+	for (i = 0, pmode = 0; i < n; i++) {
+		mode = line[x+i].mode;
+		if (i && (mode & ATTR_WDUMMY) && !(pmode & ATTR_WIDE)) {
+			line[x+i-1].u = ' ';
+			line[x+i-1].mode &= ~ATTR_WIDE;
+		}
+		g.u = (uchar)s[i];
+		line[x+i] = g;
+		#if OSC133_PATCH
+		if (!i) {
+			term.c.attr.mode &= ~ATTR_FTCS_PROMPT;
+			g.mode &= ~ATTR_FTCS_PROMPT;
+		}
+		#endif // OSC133_PATCH
+		pmode = mode;
+	}
+	if ((pmode & ATTR_WIDE) && x+n < term.col) {
+		line[x+n].u = ' ';
+		line[x+n].mode &= ~ATTR_WDUMMY;
+	}
+
+	#if DIRTY_SPAN_PATCH
+	tsetdirtspan(y, minx, (pmode & ATTR_WIDE) && x+n < term.col ? x+n+1 : x+n);
+	#else
+	term.dirty[y] = 1;
+	#endif // DIRTY_SPAN_PATCH
+	term.lastc = (uchar)s[n-1];
+
+	if (x + n < term.col) {
+		term.c.x = x + n;
+	} else {
+		term.c.x = term.col - 1;
+		#if REFLOW_PATCH
+		term.wrapcwidth[IS_SET(MODE_ALTSCREEN)] = 1;
+		#endif // REFLOW_PATCH
+		term.c.state |= CURSOR_WRAPNEXT;
+	}
+
+	return n;
+}
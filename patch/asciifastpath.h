@@ -0,0 +1 @@
+static int tputascii(const char *, int);
@@ -0,0 +1,64 @@
+/* the counters are only kept up to date while a benchmark runs */
+int benchmode = 0;
+unsigned long benchrunes = 0;
+unsigned long benchescapes = 0;
+unsigned long benchscrolls = 0;
+
+/*
+ * Feeds the given file (or standard input if "-") through twrite() in the same
+ * chunk sizes as ttyread() would and prints the throughput to standard output.
+ * Nothing is drawn and no X connection is needed.
+ */
+int
+benchmark(const char *file, int col, int row)
+{
+	static char buf[BUFSIZ];
+	int fd, ret, buflen = 0, written;
+	unsigned long long bytes = 0;
+	struct timespec start, end;
+	double secs;
+
+	if (!strcmp(file, "-"))
+		fd = STDIN_FILENO;
+	else if ((fd = open(file, O_RDONLY)) < 0)
+		die("open %s failed: %s\n", file, strerror(errno));
+
+	/* replies to the application are discarded */
+	if ((cmdfd = open("/dev/null", O_WRONLY)) < 0)
+		die("open /dev/null failed: %s\n", strerror(errno));
+
+	selinit();
+	tnew(col, row);
+	benchmode = 1;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while ((ret = read(fd, buf + buflen, LEN(buf) - buflen)) > 0) {
+		bytes += ret;
+		buflen += ret;
+		written = twrite(buf, buflen, 0);
+		#if SYNC_PATCH
+		while (twrite_aborted && written < buflen)
+			written += twrite(buf + written, buflen - written, 0);
+		#endif // SYNC_PATCH
+		buflen -= written;
+		/* keep any incomplete UTF-8 byte sequence for the next read */
+		if (buflen > 0)
+			memmove(buf, buf + written, buflen);
+	}
+	if (ret < 0)
+		die("read %s failed: %s\n", file, strerror(errno));
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1E9;
+	if (secs <= 0)
+		secs = 1E-9;
+
+	printf("%llu bytes, %lu runes, %lu escapes, %lu scrolls in %.3f s\n",
+		bytes, benchrunes, benchescapes, benchscrolls, secs);
+	printf("%.2f MB/s, %.0f runes/s, %.0f escapes/s, %.0f scrolls/s\n",
+		bytes / secs / 1E6, benchrunes / secs, benchescapes / secs, benchscrolls / secs);
+
+	if (fd != STDIN_FILENO)
+		close(fd);
+	return 0;
+}
@@ -0,0 +1,4 @@
+extern int benchmode;
+extern unsigned long benchrunes;
+extern unsigned long benchescapes;
+extern unsigned long benchscrolls;
@@ -0,0 +1,52 @@
+/*
+ * While ConfigureNotify events keep coming in, e.g. during an interactive
+ * drag, the terminal keeps its old size and the window keeps showing the old
+ * contents, which the NorthWest bit gravity anchors to the top left corner.
+ * The text is reflowed and the shell is told about the new size only once the
+ * window size has not changed for resizedelay ms.
+ */
+static struct {
+	int pending;
+	int w, h;
+	struct timespec last;
+} coalesce;
+
+void
+resizequeue(int width, int height)
+{
+	coalesce.pending = 1;
+	coalesce.w = width;
+	coalesce.h = height;
+	clock_gettime(CLOCK_MONOTONIC, &coalesce.last);
+}
+
+void
+resizecancel(void)
+{
+	coalesce.pending = 0;
+}
+
+/*
+ * Returns 1 if the pending resize was due and has been done.
+ */
+int
+resizeflush(struct timespec now)
+{
+	if (!coalesce.pending || TIMEDIFF(now, coalesce.last) < resizedelay)
+		return 0;
+	coalesce.pending = 0;
+	cresize(coalesce.w, coalesce.h);
+	return 1;
+}
+
+/*
+ * Returns the time in ms until the pending resize is due, or -1 if there is
+ * none.
+ */
+double
+resizetimeout(struct timespec now)
+{
+	if (!coalesce.pending)
+		return -1;
+	return MAX(resizedelay - TIMEDIFF(now, coalesce.last), 0);
+}
@@ -0,0 +1,4 @@
+static void resizequeue(int width, int height);
+static void resizecancel(void);
+static int resizeflush(struct timespec now);
+static double resizetimeout(struct timespec now);
@@ -0,0 +1,392 @@
+/*
+ * Lines in the scrollback history are stored as Cells, the character and an
+ * index into a table of interned attributes. A Cell is half the size of a
+ * Glyph, or a quarter with the undercurl patch. Every attribute entry counts
+ * the cells that refer to it and is reused once there are none left. Entry 0
+ * holds the attributes of a cleared cell and is never freed.
+ *
+ * histline() decodes a history line into a Glyph line for the rest of st to
+ * work with. Decoded lines are kept in a small cache and written back when
+ * they are evicted, so changes made through TLINE() are not lost. A line
+ * returned by histline() stays valid for at least HISTCACHESIZ - 1 further
+ * calls.
+ */
+#define HISTCACHESIZ 256
+#define CELLATTR_NONE UINT32_MAX
+
+typedef struct {
+	Glyph g;        /* attributes, u is always 0 */
+	uint32_t refs;  /* number of cells referring to this entry */
+	uint32_t next;  /* next entry in the hash chain or the free list */
+} CellAttr;
+
+static struct {
+	CellAttr *a;
+	uint32_t len;
+	uint32_t siz;
+	uint32_t *bucket;
+	uint32_t nbucket;
+	uint32_t free;
+} cattr;
+
+static struct {
+	int slot;      /* history slot, -1 if unused */
+	int col;       /* width of line */
+	Line line;
+} histcache[HISTCACHESIZ];
+#if DYNAMIC_HISTORY_PATCH
+static int *histcached;          /* cache entry + 1 of each slot, or 0 */
+#else
+static int histcached[HISTSIZE]; /* cache entry + 1 of each slot, or 0 */
+#endif // DYNAMIC_HISTORY_PATCH
+static int histvictim;
+static int histcol;              /* width of the history lines */
+
+static int
+cellattrcmp(const Glyph *a, const Glyph *b)
+{
+	return a->mode != b->mode || a->fg != b->fg || a->bg != b->bg
+	#if OSC8_PATCH
+		|| a->link != b->link
+	#endif // OSC8_PATCH
+	#if UNDERCURL_PATCH
+		|| a->ustyle != b->ustyle || a->ucolor[0] != b->ucolor[0]
+		|| a->ucolor[1] != b->ucolor[1] || a->ucolor[2] != b->ucolor[2]
+	#endif // UNDERCURL_PATCH
+		;
+}
+
+static uint32_t
+cellattrhash(const Glyph *g)
+{
+	uint32_t h = g->mode * 0x9e3779b1u ^ g->fg * 0x85ebca77u ^ g->bg * 0xc2b2ae3du;
+
+	#if OSC8_PATCH
+	h ^= g->link * 0x61c88647u;
+	#endif // OSC8_PATCH
+	#if UNDERCURL_PATCH
+	h ^= g->ustyle * 0x27d4eb2fu ^ (g->ucolor[0] + (g->ucolor[1] << 8) +
+		(g->ucolor[2] << 16)) * 0x165667b1u;
+	#endif // UNDERCURL_PATCH
+	return (h ^ (h >> 15)) & (cattr.nbucket - 1);
+}
+
+static void
+cellattrrehash(uint32_t nbucket)
+{
+	uint32_t i, h;
+
+	cattr.nbucket = nbucket;
+	cattr.bucket = xrealloc(cattr.bucket, nbucket * sizeof(*cattr.bucket));
+	for (i = 0; i < nbucket; i++)
+		cattr.bucket[i] = CELLATTR_NONE;
+	for (i = 0; i < cattr.len; i++) {
+		if (i && !cattr.a[i].refs)
+			continue;
+		h = cellattrhash(&cattr.a[i].g);
+		cattr.a[i].next = cattr.bucket[h];
+		cattr.bucket[h] = i;
+	}
+}
+
+/*
+ * Returns the attribute entry of g, adding n references to it.
+ */
+static uint32_t
+cellattr(const Glyph *g, uint32_t n)
+{
+	uint32_t i, h;
+
+	h = cellattrhash(g);
+	for (i = cattr.bucket[h]; i != CELLATTR_NONE; i = cattr.a[i].next) {
+		if (!cellattrcmp(&cattr.a[i].g, g))
+			goto found;
+	}
+
+	if (cattr.free != CELLATTR_NONE) {
+		i = cattr.free;
+		cattr.free = cattr.a[i].next;
+	} else {
+		if (cattr.len == cattr.siz) {
+			cattr.siz *= 2;
+			cattr.a = xrealloc(cattr.a, cattr.siz * sizeof(*cattr.a));
+		}
+		i = cattr.len++;
+		if (cattr.len > cattr.nbucket) {
+			cattr.a[i].refs = 0;
+			cellattrrehash(cattr.nbucket * 2);
+			h = cellattrhash(g);
+		}
+	}
+	cattr.a[i].g = *g;
+	cattr.a[i].g.u = 0;
+	cattr.a[i].refs = 0;
+	cattr.a[i].next = cattr.bucket[h];
+	cattr.bucket[h] = i;
+
+found:
+	if (i)
+		cattr.a[i].refs += n;
+	return i;
+}
+
+static void
+cellattrunref(uint32_t i, uint32_t n)
+{
+	uint32_t *p;
+
+	if (!i || (cattr.a[i].refs -= n))
+		return;
+
+	/* unlink the entry from its hash chain and put it on the free list */
+	for (p = &cattr.bucket[cellattrhash(&cattr.a[i].g)]; *p != i; p = &cattr.a[*p].next)
+		;
+	*p = cattr.a[i].next;
+	cattr.a[i].next = cattr.free;
+	cattr.free = i;
+}
+
+#if !COMPRESSED_HISTORY_PATCH
+static void
+histencode(int i, const Glyph *line, int col)
+{
+	Cell *c = HIST(i);
+	uint32_t a;
+	int x, n, j, len = MIN(col, histcol);
+
+	#if LAZY_ALLOC_PATCH
+	if (!c)
+		c = HIST(i) = xmalloc(histcol * sizeof(Cell));
+	else
+	#endif // LAZY_ALLOC_PATCH
+	for (x = 0; x < histcol; x += n) {
+		for (n = 1; x + n < histcol && c[x + n].attr == c[x].attr; n++)
+			;
+		cellattrunref(c[x].attr, n);
+	}
+
+	for (x = 0; x < len; x += n) {
+		for (n = 1; x + n < len && !cellattrcmp(&line[x + n], &line[x]); n++)
+			;
+		a = cellattr(&line[x], n);
+		for (j = x; j < x + n; j++)
+			c[j] = (Cell){ .u = line[j].u, .attr = a };
+	}
+	for (; x < histcol; x++)
+		c[x] = (Cell){ .u = ' ', .attr = 0 };
+}
+
+static void
+histdecode(int i, Glyph *line, int col)
+{
+	const Cell *c = HIST(i);
+	int x;
+
+	for (x = 0; c && x < MIN(col, histcol); x++) {
+		line[x] = cattr.a[c[x].attr].g;
+		line[x].u = c[x].u;
+	}
+	for (; x < col; x++)
+		tclearglyph(&line[x], 0);
+}
+
+static int
+histchanged(int i, const Glyph *line)
+{
+	const Cell *c = HIST(i);
+	int x;
+
+	#if LAZY_ALLOC_PATCH
+	/* an unallocated line decodes as cleared cells */
+	if (!c) {
+		for (x = 0; x < histcol; x++) {
+			if (line[x].u != ' ' || cellattrcmp(&line[x], &cattr.a[0].g))
+				return 1;
+		}
+		return 0;
+	}
+	#endif // LAZY_ALLOC_PATCH
+	for (x = 0; x < histcol; x++) {
+		if (line[x].u != c[x].u || cellattrcmp(&line[x], &cattr.a[c[x].attr].g))
+			return 1;
+	}
+	return 0;
+}
+
+static void
+histreset(int i)
+{
+	#if LAZY_ALLOC_PATCH
+	free(HIST(i));
+	HIST(i) = NULL;
+	#else
+	HIST(i) = xrealloc(HIST(i), histcol * sizeof(Cell));
+	memset(HIST(i), 0, histcol * sizeof(Cell));
+	#endif // LAZY_ALLOC_PATCH
+}
+
+#if DYNAMIC_HISTORY_PATCH
+static size_t
+histmem(void)
+{
+	return (size_t)term.histcap * histcol * sizeof(Cell);
+}
+#endif // DYNAMIC_HISTORY_PATCH
+#endif // COMPRESSED_HISTORY_PATCH
+
+static void
+histevict(int e, int writeback)
+{
+	const Glyph *line = histcache[e].line;
+	int i = histcache[e].slot;
+
+	if (!line || i < 0)
+		return;
+	histcache[e].slot = -1;
+	histcached[i] = 0;
+
+	/* only encode the line again if it has been changed */
+	if (writeback && histchanged(i, line))
+		histencode(i, line, histcol);
+}
+
+/*
+ * Returns history slot i as a line of at least term.col glyphs.
+ */
+Line
+histline(int i)
+{
+	int e = histcached[i] - 1, col = MAX(histcol, term.col);
+
+	if (e >= 0 && histcache[e].col == col)
+		return histcache[e].line;
+
+	if (e >= 0) {
+		histevict(e, 1);
+	} else {
+		e = histvictim;
+		histvictim = (histvictim + 1) % HISTCACHESIZ;
+		histevict(e, 1);
+	}
+	if (histcache[e].col != col) {
+		histcache[e].line = xrealloc(histcache[e].line, col * sizeof(Glyph));
+		histcache[e].col = col;
+	}
+	histcache[e].slot = i;
+	histcached[i] = e + 1;
+	histdecode(i, histcache[e].line, col);
+
+	return histcache[e].line;
+}
+
+/*
+ * Stores a line of col glyphs in history slot i.
+ */
+void
+histstore(int i, const Glyph *line, int col)
+{
+	if (histcached[i])
+		histevict(histcached[i] - 1, 0);
+	histencode(i, line, col);
+}
+
+#if DYNAMIC_HISTORY_PATCH
+/*
+ * Sets up the history slots from up to to, which have just been allocated.
+ */
+void
+histextend(int from, int to)
+{
+	int i;
+
+	histcached = xrealloc(histcached, to * sizeof(*histcached));
+	for (i = from; i < to; i++) {
+		histcached[i] = 0;
+		HIST(i) = NULL;
+		histreset(i);
+	}
+}
+
+/*
+ * Swaps the lines in history slots i and j.
+ */
+void
+histswap(int i, int j)
+{
+	HistEntry h = HIST(i);
+	int e = histcached[i];
+
+	HIST(i) = HIST(j);
+	HIST(j) = h;
+	histcached[i] = histcached[j];
+	histcached[j] = e;
+	if (histcached[i])
+		histcache[histcached[i] - 1].slot = i;
+	if (histcached[j])
+		histcache[histcached[j] - 1].slot = j;
+}
+
+/*
+ * Returns the memory taken up by the history, not counting the cache.
+ */
+size_t
+histmemused(void)
+{
+	return histmem() + cattr.siz * sizeof(*cattr.a);
+}
+#endif // DYNAMIC_HISTORY_PATCH
+
+#if OSC8_PATCH
+/*
+ * Counts the hyperlinks of the history lines, see linkcount(). The cells of a
+ * line refer to the attribute entries that hold the links, and a line that has
+ * been decoded may have been changed since.
+ */
+void
+histmarklinks(void)
+{
+	uint32_t i;
+	int e, x;
+
+	for (i = 1; i < cattr.len; i++) {
+		if (cattr.a[i].refs)
+			linkmark(cattr.a[i].g.link);
+	}
+	for (e = 0; e < HISTCACHESIZ; e++) {
+		if (!histcache[e].line || histcache[e].slot < 0)
+			continue;
+		for (x = 0; x < histcache[e].col; x++)
+			linkmark(histcache[e].line[x].link);
+	}
+}
+#endif // OSC8_PATCH
+
+/*
+ * Empties the whole history and makes its lines col cells wide.
+ */
+void
+histclear(int col)
+{
+	Glyph g;
+	int i;
+
+	for (i = 0; i < HISTCACHESIZ; i++)
+		histevict(i, 0);
+
+	histcol = col;
+	for (i = 0; i < HISTLINES; i++)
+		histreset(i);
+
+	cattr.siz = 64;
+	cattr.a = xrealloc(cattr.a, cattr.siz * sizeof(*cattr.a));
+	cattr.len = 1;
+	cattr.free = CELLATTR_NONE;
+	tclearglyph(&g, 0);
+	g.u = 0;
+	#if UNDERCURL_PATCH
+	g.ustyle = 0;
+	g.ucolor[0] = g.ucolor[1] = g.ucolor[2] = 0;
+	#endif // UNDERCURL_PATCH
+	cattr.a[0] = (CellAttr){ .g = g };
+	cellattrrehash(256);
+}
@@ -0,0 +1,11 @@
+Line histline(int);
+void histstore(int, const Glyph *, int);
+void histclear(int);
+#if OSC8_PATCH
+void histmarklinks(void);
+#endif // OSC8_PATCH
+#if DYNAMIC_HISTORY_PATCH
+void histextend(int, int);
+size_t histmemused(void);
+void histswap(int, int);
+#endif // DYNAMIC_HISTORY_PATCH
@@ -1,4 +1,61 @@
-#if COPYURL_HIGHLIGHT_SELECTED_URLS_PATCH
+#if REFLOW_PATCH && URL_CACHE_PATCH
+/* select and copy the previous url, going on into the scrollback history and
+ * starting over from the bottom once there are no urls left before it. The
+ * view is scrolled to show the url if it is not on screen.
+ */
+void
+copyurl(const Arg *arg) {
+	UrlSpan u;
+	Arg a;
+	int n, found;
+
+	if (sel.ob.x >= 0 && sel.alt == IS_SET(MODE_ALTSCREEN))
+		found = urlbefore(sel.nb.x, sel.nb.y, &u);
+	else
+		found = urlbefore(term.col, term.row - 1, &u);
+	selclear();
+
+	if (!found) {
+		a.i = term.scr;
+		kscrolldown(&a);
+		if (!urlbefore(term.col, term.row - 1, &u))
+			return;
+	}
+
+	/* bring the url into view */
+	n = term.scr;
+	if (u.y1 < 0) {
+		a.i = -u.y1;
+		kscrollup(&a);
+	} else if (u.y2 >= term.row) {
+		a.i = u.y2 - term.row + 1;
+		kscrolldown(&a);
+	}
+	n = term.scr - n;
+	u.y1 += n;
+	u.y2 += n;
+	if (u.y1 < 0)
+		u.x1 = u.y1 = 0;
+	if (u.y2 >= term.row) {
+		u.x2 = term.col - 1;
+		u.y2 = term.row - 1;
+	}
+
+	/* select and copy */
+	sel.mode = 1;
+	sel.type = SEL_REGULAR;
+	sel.alt = IS_SET(MODE_ALTSCREEN);
+	sel.snap = 0;
+	sel.ob.x = u.x1;
+	sel.ob.y = u.y1;
+	sel.oe.x = u.x2;
+	sel.oe.y = u.y2;
+	selnormalize();
+	tsetdirt(sel.nb.y, sel.ne.y);
+	xsetsel(getsel());
+	xclipcopy();
+}
+#elif COPYURL_HIGHLIGHT_SELECTED_URLS_PATCH
 void
 tsetcolor( int row, int start, int end, uint32_t fg, uint32_t bg )
 {
@@ -1,5 +1,5 @@
 void copyurl(const Arg *);
-#if COPYURL_HIGHLIGHT_SELECTED_URLS_PATCH
+#if COPYURL_HIGHLIGHT_SELECTED_URLS_PATCH && !(REFLOW_PATCH && URL_CACHE_PATCH)
 static void tsetcolor(int, int, int, uint32_t, uint32_t);
 static char * findlastany(char *, const char**, size_t);
 #endif // COPYURL_HIGHLIGHT_SELECTED_URLS_PATCH
\ No newline at end of file
@@ -0,0 +1,441 @@
+/*
+ * Table driven parsing of control codes and escape sequences. vtputc() takes
+ * every rune from tputc() and looks up what to do with it by the state of the
+ * parser and the class of the byte, rather than testing the term.esc flags
+ * one after another. The state is read from term.esc through a table, as the
+ * sequence handlers, including those of the sixel and sync patches, still set
+ * and clear the flags themselves.
+ *
+ * Within a CSI sequence, csiparsebyte() accumulates the parameters as the
+ * bytes arrive, through a second table.
+ */
+/* Parameters larger than this are left to strtol() to handle overflow */
+#define CSI_PARAM_MAX 99999999
+
+static const uchar csiclass[128] = {
+	/* 0x00 - 0x1f are control codes and never end up in a sequence */
+	CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER,
+	CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER,
+	CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER,
+	CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER,
+	/*  ' '      '!'       '"'       '#'       '$'       '%'       '&'       '\'' */
+	CC_SIGN,  CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER,
+	/*  '('      ')'       '*'       '+'       ','       '-'       '.'       '/' */
+	CC_OTHER, CC_OTHER, CC_OTHER, CC_SIGN,  CC_OTHER, CC_SIGN,  CC_OTHER, CC_OTHER,
+	/*  '0' - '7' */
+	CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT,
+	/*  '8'      '9'       ':'       ';'       '<'       '='       '>'       '?' */
+	CC_DIGIT, CC_DIGIT, CC_COLON, CC_SEMI,  CC_OTHER, CC_OTHER, CC_OTHER, CC_PRIV,
+	/* 0x40 - 0x7e are final bytes */
+	CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL,
+	CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL,
+	CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL,
+	CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL,
+	CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL,
+	CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL,
+	CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL,
+	CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_FINAL, CC_OTHER,
+};
+
+/*
+ * Transitions for each state and byte class. The colon separated forms and
+ * signed parameters are rare enough that they are handed over to csiparse(),
+ * which keeps the exact behaviour of the strtol() based parser for them.
+ */
+static const struct {
+	uchar next;
+	uchar action;
+} csitable[CS_LAST][CC_LAST] = {
+	[CS_START] = {
+		[CC_DIGIT]    = { CS_NUM,      CA_DIGIT },
+		[CC_SEMI]     = { CS_PARAM,    CA_NEXT },
+		[CC_COLON]    = { CS_FALLBACK, CA_NONE },
+		[CC_PRIV]     = { CS_PARAM,    CA_PRIV },
+		[CC_SIGN]     = { CS_FALLBACK, CA_NONE },
+		[CC_FINAL]    = { CS_START,    CA_END },
+		[CC_OTHER]    = { CS_MODE,     CA_STOP },
+		[CC_FALLBACK] = { CS_FALLBACK, CA_NONE },
+	},
+	[CS_PARAM] = {
+		[CC_DIGIT]    = { CS_NUM,      CA_DIGIT },
+		[CC_SEMI]     = { CS_PARAM,    CA_NEXT },
+		[CC_COLON]    = { CS_FALLBACK, CA_NONE },
+		[CC_PRIV]     = { CS_MODE,     CA_STOP },
+		[CC_SIGN]     = { CS_FALLBACK, CA_NONE },
+		[CC_FINAL]    = { CS_START,    CA_END },
+		[CC_OTHER]    = { CS_MODE,     CA_STOP },
+		[CC_FALLBACK] = { CS_FALLBACK, CA_NONE },
+	},
+	[CS_NUM] = {
+		[CC_DIGIT]    = { CS_NUM,      CA_DIGIT },
+		[CC_SEMI]     = { CS_PARAM,    CA_NEXT },
+		[CC_COLON]    = { CS_FALLBACK, CA_NONE },
+		[CC_PRIV]     = { CS_MODE,     CA_STOP },
+		[CC_SIGN]     = { CS_MODE,     CA_STOP },
+		[CC_FINAL]    = { CS_START,    CA_END },
+		[CC_OTHER]    = { CS_MODE,     CA_STOP },
+		[CC_FALLBACK] = { CS_FALLBACK, CA_NONE },
+	},
+	[CS_MODE] = {
+		[CC_DIGIT]    = { CS_IGNORE,   CA_MODE },
+		[CC_SEMI]     = { CS_IGNORE,   CA_MODE },
+		[CC_COLON]    = { CS_IGNORE,   CA_MODE },
+		[CC_PRIV]     = { CS_IGNORE,   CA_MODE },
+		[CC_SIGN]     = { CS_IGNORE,   CA_MODE },
+		[CC_FINAL]    = { CS_START,    CA_MODEEND },
+		[CC_OTHER]    = { CS_IGNORE,   CA_MODE },
+		[CC_FALLBACK] = { CS_FALLBACK, CA_NONE },
+	},
+	[CS_IGNORE] = {
+		[CC_DIGIT]    = { CS_IGNORE,   CA_NONE },
+		[CC_SEMI]     = { CS_IGNORE,   CA_NONE },
+		[CC_COLON]    = { CS_IGNORE,   CA_NONE },
+		[CC_PRIV]     = { CS_IGNORE,   CA_NONE },
+		[CC_SIGN]     = { CS_IGNORE,   CA_NONE },
+		[CC_FINAL]    = { CS_START,    CA_DONE },
+		[CC_OTHER]    = { CS_IGNORE,   CA_NONE },
+		[CC_FALLBACK] = { CS_IGNORE,   CA_NONE },
+	},
+	[CS_FALLBACK] = {
+		[CC_DIGIT]    = { CS_FALLBACK, CA_NONE },
+		[CC_SEMI]     = { CS_FALLBACK, CA_NONE },
+		[CC_COLON]    = { CS_FALLBACK, CA_NONE },
+		[CC_PRIV]     = { CS_FALLBACK, CA_NONE },
+		[CC_SIGN]     = { CS_FALLBACK, CA_NONE },
+		[CC_FINAL]    = { CS_START,    CA_PARSE },
+		[CC_OTHER]    = { CS_FALLBACK, CA_NONE },
+		[CC_FALLBACK] = { CS_FALLBACK, CA_NONE },
+	},
+};
+
+static inline void
+csipusharg(void)
+{
+	#if UNDERCURL_PATCH
+	int i;
+
+	for (i = 0; i < CAR_PER_ARG; i++)
+		csiescseq.carg[csiescseq.narg][i] = -1;
+	#endif // UNDERCURL_PATCH
+	csiescseq.arg[csiescseq.narg++] = csiescseq.val;
+	csiescseq.val = 0;
+}
+
+/*
+ * Feeds one byte of a CSI sequence, which has already been added to
+ * csiescseq.buf, to the parser. The parameters are accumulated as they
+ * arrive, leaving csiescseq in the same state as csiparse() would.
+ *
+ * Returns 1 when the sequence is complete and ready for csihandle().
+ */
+int
+csiparsebyte(Rune u)
+{
+	int cls = (u < 128) ? csiclass[u] : CC_FALLBACK;
+	int action = csitable[csiescseq.state][cls].action;
+
+	csiescseq.state = csitable[csiescseq.state][cls].next;
+
+	switch (action) {
+	case CA_NONE:
+		return 0;
+	case CA_PRIV:
+		csiescseq.priv = 1;
+		return 0;
+	case CA_DIGIT:
+		csiescseq.val = csiescseq.val * 10 + (u - '0');
+		if (csiescseq.val > CSI_PARAM_MAX)
+			csiescseq.state = CS_FALLBACK;
+		return 0;
+	case CA_NEXT:
+		csipusharg();
+		if (csiescseq.narg == ESC_ARG_SIZ) {
+			csiescseq.mode[0] = u;
+			csiescseq.state = CS_MODE;
+		}
+		return 0;
+	case CA_STOP:
+	case CA_END:
+		csipusharg();
+		csiescseq.mode[0] = u;
+		return action == CA_END;
+	case CA_MODE:
+		csiescseq.mode[1] = u;
+		return 0;
+	case CA_MODEEND:
+		csiescseq.mode[1] = u;
+		return 1;
+	case CA_PARSE:
+		csiparse();
+		/* FALLTHROUGH */
+	case CA_DONE:
+		return 1;
+	}
+
+	return 0;
+}
+
+static const uchar vtclass[0xa0] = {
+	/* 0x00 - 0x0f, BEL */
+	VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_STRTERM,
+	VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,
+	/* 0x10 - 0x1f, CAN, SUB and ESC */
+	VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,      VC_C0,
+	VC_STRTERM, VC_C0,      VC_STRTERM, VC_STRTERM, VC_C0,      VC_C0,      VC_C0,      VC_C0,
+	/* 0x20 - 0x3f */
+	VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,
+	VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,
+	VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,
+	VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,   VC_INTER,
+	/* 0x40 - 0x7e, DEL */
+	VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,
+	VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,
+	VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,
+	VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,
+	VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,
+	VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,
+	VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,
+	VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_FINAL,   VC_C0,
+	/* 0x80 - 0x9f */
+	VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,
+	VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,
+	VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,
+	VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,      VC_C1,
+};
+
+/*
+ * Control codes act right away, even within a sequence. Only in a string are
+ * the C0 controls other than the string terminators part of it.
+ */
+static const uchar vttable[VS_LAST][VC_LAST] = {
+	[VS_GROUND] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_CONTROL,
+		[VC_C1]      = VA_CONTROL,
+		[VC_INTER]   = VA_PRINT,
+		[VC_FINAL]   = VA_PRINT,
+		[VC_PRINT]   = VA_PRINT,
+	},
+	[VS_ESC] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_CONTROL,
+		[VC_C1]      = VA_CONTROL,
+		[VC_INTER]   = VA_ESC,
+		[VC_FINAL]   = VA_ESC,
+		[VC_PRINT]   = VA_ESC,
+	},
+	[VS_CSI] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_CONTROL,
+		[VC_C1]      = VA_CONTROL,
+		[VC_INTER]   = VA_CSI,
+		[VC_FINAL]   = VA_CSI,
+		[VC_PRINT]   = VA_CSI,
+	},
+	[VS_DCS] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_CONTROL,
+		[VC_C1]      = VA_CONTROL,
+		[VC_INTER]   = VA_DCS,
+		[VC_FINAL]   = VA_DCS,
+		[VC_PRINT]   = VA_DCS,
+	},
+	[VS_UTF8] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_CONTROL,
+		[VC_C1]      = VA_CONTROL,
+		[VC_INTER]   = VA_UTF8,
+		[VC_FINAL]   = VA_UTF8,
+		[VC_PRINT]   = VA_UTF8,
+	},
+	[VS_CHARSET] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_CONTROL,
+		[VC_C1]      = VA_CONTROL,
+		[VC_INTER]   = VA_CHARSET,
+		[VC_FINAL]   = VA_CHARSET,
+		[VC_PRINT]   = VA_CHARSET,
+	},
+	[VS_TEST] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_CONTROL,
+		[VC_C1]      = VA_CONTROL,
+		[VC_INTER]   = VA_TEST,
+		[VC_FINAL]   = VA_TEST,
+		[VC_PRINT]   = VA_TEST,
+	},
+	[VS_STR] = {
+		[VC_C0]      = VA_STRPUT,
+		[VC_STRTERM] = VA_STREND,
+		[VC_C1]      = VA_STREND,
+		[VC_INTER]   = VA_STRPUT,
+		[VC_FINAL]   = VA_STRPUT,
+		[VC_PRINT]   = VA_STRPUT,
+	},
+	/* the string itself is read by the sixel parser, see twrite() */
+	[VS_STRDCS] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_STREND,
+		[VC_C1]      = VA_STREND,
+		[VC_INTER]   = VA_DCS,
+		[VC_FINAL]   = VA_DCS,
+		[VC_PRINT]   = VA_DCS,
+	},
+	[VS_STRCSI] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_STREND,
+		[VC_C1]      = VA_STREND,
+		[VC_INTER]   = VA_CSI,
+		[VC_FINAL]   = VA_CSI,
+		[VC_PRINT]   = VA_CSI,
+	},
+	[VS_STRRAW] = {
+		[VC_C0]      = VA_CONTROL,
+		[VC_STRTERM] = VA_STREND,
+		[VC_C1]      = VA_STREND,
+		[VC_INTER]   = VA_PRINT,
+		[VC_FINAL]   = VA_PRINT,
+		[VC_PRINT]   = VA_PRINT,
+	},
+};
+
+/* the state for every value of term.esc, filled in by vtinit() */
+static uchar vtstates[256];
+static int vtready;
+
+static int
+vtstate(int esc)
+{
+	if (esc & ESC_STR) {
+		#if SIXEL_PATCH
+		if (esc & ESC_DCS) {
+			if (!(esc & ESC_START))
+				return VS_STRRAW;
+			return (esc & ESC_CSI) ? VS_STRCSI : VS_STRDCS;
+		}
+		#endif // SIXEL_PATCH
+		return VS_STR;
+	}
+	if (!(esc & ESC_START))
+		return VS_GROUND;
+	if (esc & ESC_CSI)
+		return VS_CSI;
+	#if SIXEL_PATCH
+	if (esc & ESC_DCS)
+		return VS_DCS;
+	#endif // SIXEL_PATCH
+	if (esc & ESC_UTF8)
+		return VS_UTF8;
+	if (esc & ESC_ALTCHARSET)
+		return VS_CHARSET;
+	if (esc & ESC_TEST)
+		return VS_TEST;
+	return VS_ESC;
+}
+
+static void
+vtinit(void)
+{
+	int i;
+
+	for (i = 0; i < LEN(vtstates); i++)
+		vtstates[i] = vtstate(i);
+	vtready = 1;
+}
+
+/*
+ * Handles rune u, which is encoded as the len bytes in c, if it is a control
+ * code or part of a sequence.
+ *
+ * Returns 0 if it is to be printed.
+ */
+int
+vtputc(Rune u, char *c, int len)
+{
+	int cls = (u < LEN(vtclass)) ? vtclass[u] : VC_PRINT;
+
+	if (!vtready)
+		vtinit();
+
+	switch (vttable[vtstates[term.esc]][cls]) {
+	case VA_PRINT:
+		return 0;
+	case VA_STRPUT:
+		#if STRSTREAM_PATCH
+		strput(c, len);
+		#else
+		/* an unterminated string keeps growing, as in tputc() */
+		if (strescseq.len+len >= strescseq.siz) {
+			if (strescseq.siz > (SIZE_MAX - UTF_SIZ) / 2)
+				return 1;
+			strescseq.siz *= 2;
+			strescseq.buf = xrealloc(strescseq.buf, strescseq.siz);
+		}
+		memmove(&strescseq.buf[strescseq.len], c, len);
+		strescseq.len += len;
+		#endif // STRSTREAM_PATCH
+		return 1;
+	case VA_STREND:
+		#if SIXEL_PATCH
+		term.esc &= ~(ESC_START|ESC_STR|ESC_DCS);
+		#else
+		term.esc &= ~(ESC_START|ESC_STR);
+		#endif // SIXEL_PATCH
+		term.esc |= ESC_STR_END;
+		/* FALLTHROUGH */
+	case VA_CONTROL:
+		/* in UTF-8 mode ignore handling C1 control characters */
+		if (IS_SET(MODE_UTF8) && cls == VC_C1)
+			return 1;
+		tcontrolcode(u);
+		/* control codes are not shown ever */
+		if (!term.esc)
+			term.lastc = 0;
+		return 1;
+	case VA_CSI:
+		csiescseq.buf[csiescseq.len++] = u;
+		if (csiparsebyte(u)) {
+			term.esc = 0;
+			csihandle();
+		} else if (csiescseq.len >= sizeof(csiescseq.buf)-1) {
+			term.esc = 0;
+			csiparse();
+			csihandle();
+		}
+		return 1;
+	#if SIXEL_PATCH
+	case VA_DCS:
+		/* Skip if DCS escape sequence buffer is full */
+		if (csiescseq.len >= sizeof(csiescseq.buf) - 1)
+			return 1;
+		csiescseq.buf[csiescseq.len++] = u;
+		if (cls == VC_FINAL || csiescseq.len >= sizeof(csiescseq.buf)-1) {
+			csiparse();
+			dcshandle();
+		}
+		return 1;
+	#endif // SIXEL_PATCH
+	case VA_UTF8:
+		tdefutf8(u);
+		break;
+	case VA_CHARSET:
+		tdeftran(u);
+		break;
+	case VA_TEST:
+		tdectest(u);
+		break;
+	case VA_ESC:
+		if (!eschandle(u))
+			return 1;
+		/* sequence already finished */
+		break;
+	}
+	term.esc = 0;
+	#if BENCHMARK_PATCH
+	if (benchmode)
+		benchescapes++;
+	#endif // BENCHMARK_PATCH
+
+	/* all characters which form part of a sequence are not printed */
+	return 1;
+}
@@ -0,0 +1,78 @@
+#include <stddef.h>
+
+enum csiparser_class {
+	CC_DIGIT,    /* 0-9 */
+	CC_SEMI,     /* ; */
+	CC_COLON,    /* : */
+	CC_PRIV,     /* ? */
+	CC_SIGN,     /* space, + and -, which strtol() skips or accepts */
+	CC_FINAL,    /* 0x40-0x7E */
+	CC_OTHER,    /* intermediates and other parameter bytes */
+	CC_FALLBACK, /* anything else, including runes that do not fit in a byte */
+	CC_LAST,
+};
+
+enum csiparser_state {
+	CS_START,    /* nothing read yet */
+	CS_PARAM,    /* at the start of a parameter */
+	CS_NUM,      /* in the digits of a parameter */
+	CS_MODE,     /* parsing stopped, the next byte is the second mode byte */
+	CS_IGNORE,   /* parsing stopped, waiting for the final byte */
+	CS_FALLBACK, /* not handled by the table, use csiparse() on the final byte */
+	CS_LAST,
+};
+
+enum csiparser_action {
+	CA_NONE,
+	CA_PRIV,     /* set the private flag */
+	CA_DIGIT,    /* accumulate a digit */
+	CA_NEXT,     /* store the parameter and continue with the next */
+	CA_STOP,     /* store the parameter, the byte is the first mode byte */
+	CA_END,      /* as CA_STOP, and the sequence is complete */
+	CA_MODE,     /* the byte is the second mode byte */
+	CA_MODEEND,  /* as CA_MODE, and the sequence is complete */
+	CA_DONE,     /* the sequence is complete */
+	CA_PARSE,    /* the sequence is complete, parse it with csiparse() */
+};
+
+/* Classes of the bytes tputc() dispatches on */
+enum vt_class {
+	VC_C0,       /* C0 controls and DEL */
+	VC_STRTERM,  /* BEL, CAN, SUB and ESC, which also end a string */
+	VC_C1,       /* 0x80-0x9f */
+	VC_INTER,    /* 0x20-0x3f, intermediate and parameter bytes */
+	VC_FINAL,    /* 0x40-0x7e */
+	VC_PRINT,    /* anything else */
+	VC_LAST,
+};
+
+/* States, each for a combination of term.esc flags */
+enum vt_state {
+	VS_GROUND,   /* no sequence */
+	VS_ESC,      /* after ESC */
+	VS_CSI,
+	VS_DCS,      /* the parameters of a DCS, with the sixel patch */
+	VS_UTF8,     /* after ESC % */
+	VS_CHARSET,  /* after ESC ( ) * or + */
+	VS_TEST,     /* after ESC # */
+	VS_STR,      /* in the string of an OSC, DCS, APC or PM */
+	VS_STRDCS,   /* in a DCS started by ESC P, with the sixel patch */
+	VS_STRCSI,   /* in a DCS started by the C1 control within a CSI */
+	VS_STRRAW,   /* in a DCS started by the C1 control, with the sixel patch */
+	VS_LAST,
+};
+
+enum vt_action {
+	VA_PRINT,    /* not part of a sequence */
+	VA_CONTROL,  /* a control code */
+	VA_STRPUT,   /* append to the string */
+	VA_STREND,   /* end the string, then as VA_CONTROL */
+	VA_CSI,      /* feed to csiparsebyte() */
+	VA_DCS,      /* collect the parameters of a DCS */
+	VA_ESC,      /* the byte after ESC */
+	VA_UTF8,
+	VA_CHARSET,
+	VA_TEST,
+};
+
+int vtputc(Rune, char *, int);
@@ -0,0 +1,49 @@
+/*
+ * Besides being clean (0) or dirty as a whole (1), a line can be DIRTY_SPAN
+ * when only the columns [dirtyminx, dirtymaxx) have changed since it was last
+ * drawn. Anything that marks a line dirty the usual way still has the whole
+ * line redrawn.
+ */
+void
+tsetdirtspan(int y, int x1, int x2)
+{
+	if (term.dirty[y] == 1)
+		return;
+	if (!term.dirty[y]) {
+		term.dirty[y] = DIRTY_SPAN;
+		term.dirtyminx[y] = x1;
+		term.dirtymaxx[y] = x2;
+		return;
+	}
+	term.dirtyminx[y] = MIN(term.dirtyminx[y], x1);
+	term.dirtymaxx[y] = MAX(term.dirtymaxx[y], x2);
+}
+
+/*
+ * Narrows the columns [*x1, *x2) to be drawn of line y down to its dirty span,
+ * widened so that no glyph is drawn only in part.
+ */
+void
+tdirtspan(Line line, int y, int *x1, int *x2)
+{
+	int minx = MAX(*x1, term.dirtyminx[y]);
+	int maxx = MIN(*x2, term.dirtymaxx[y]);
+
+	#if LIGATURES_PATCH || WIDE_GLYPHS_PATCH
+	/* glyphs are shaped, and may overflow their cell, within a run of cells
+	 * with the same attributes */
+	while (minx > *x1 && !ATTRCMP(line[minx-1], line[minx]))
+		minx--;
+	while (maxx < *x2 && !ATTRCMP(line[maxx-1], line[maxx]))
+		maxx++;
+	#endif // LIGATURES_PATCH | WIDE_GLYPHS_PATCH
+
+	/* a wide glyph is drawn from its first cell across both of its cells */
+	if (minx > *x1 && (line[minx-1].mode & ATTR_WIDE))
+		minx--;
+	if (maxx < *x2 && (line[maxx].mode & ATTR_WDUMMY))
+		maxx++;
+
+	*x1 = minx;
+	*x2 = maxx;
+}
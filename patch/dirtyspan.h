@@ -0,0 +1,4 @@
+#define DIRTY_SPAN 2
+
+static void tsetdirtspan(int, int, int);
+static void tdirtspan(Line, int, int *, int *);
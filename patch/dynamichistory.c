@@ -0,0 +1,81 @@
+/*
+ * The history is a ring of term.histcap lines, allocated in chunks of
+ * HISTCHUNK lines as lines scroll off the screen. It stops growing once it
+ * holds histsize lines or takes up histmemory MiB, after which the oldest
+ * lines are reused as before.
+ */
+static size_t
+histmemtotal(void)
+{
+	#if COMPACT_GLYPH_PATCH
+	return histmemused();
+	#else
+	return (size_t)term.histcap * (term.col * sizeof(Glyph) + sizeof(Line));
+	#endif // COMPACT_GLYPH_PATCH
+}
+
+/*
+ * Adds a chunk of col wide lines to the end of the history ring. The order of
+ * the lines is only kept if term.histi is the last line of the ring, or if
+ * the whole history is rewritten afterwards.
+ *
+ * Returns 1 if the history was grown.
+ */
+int
+histgrow(int col)
+{
+	size_t mem;
+	int n = term.histcap / HISTCHUNK;
+
+	if (term.histcap) {
+		if (term.histcap >= histsize)
+			return 0;
+		mem = histmemtotal();
+		if (histmemory && mem + mem / term.histcap * HISTCHUNK >
+				(size_t)histmemory << 20)
+			return 0;
+	}
+
+	term.hist = xrealloc(term.hist, (n + 1) * sizeof(*term.hist));
+	term.hist[n] = xmalloc(HISTCHUNK * sizeof(**term.hist));
+	term.histcap += HISTCHUNK;
+	#if COMPACT_GLYPH_PATCH
+	histextend(term.histcap - HISTCHUNK, term.histcap);
+	#elif LAZY_ALLOC_PATCH
+	memset(term.hist[n], 0, HISTCHUNK * sizeof(**term.hist));
+	#else
+	for (int i = 0; i < HISTCHUNK; i++)
+		term.hist[n][i] = xmalloc(col * sizeof(Glyph));
+	#endif // COMPACT_GLYPH_PATCH
+
+	return 1;
+}
+
+/*
+ * Grows the history ring and moves the lines above term.histi up, so that the
+ * new slots are right below the oldest line. A reflow can leave term.histi
+ * anywhere in the ring.
+ *
+ * Returns 1 if the history was grown.
+ */
+int
+histgrowring(int col)
+{
+	int i;
+	#if !COMPACT_GLYPH_PATCH
+	Line temp;
+	#endif // COMPACT_GLYPH_PATCH
+
+	if (!histgrow(col))
+		return 0;
+	for (i = term.histcap - HISTCHUNK - 1; i > term.histi; i--) {
+		#if COMPACT_GLYPH_PATCH
+		histswap(i, i + HISTCHUNK);
+		#else
+		temp = HIST(i);
+		HIST(i) = HIST(i + HISTCHUNK);
+		HIST(i + HISTCHUNK) = temp;
+		#endif // COMPACT_GLYPH_PATCH
+	}
+	return 1;
+}
@@ -0,0 +1,2 @@
+int histgrow(int);
+int histgrowring(int);
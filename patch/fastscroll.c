@@ -0,0 +1,43 @@
+/*
+ * term.line is a window of term.row lines into a larger allocation. Scrolling
+ * the whole screen up by n lines moves the window down by n and puts the n
+ * lines that went off the top right after its end, rather than rotating every
+ * line pointer on the screen. Once the window runs into the end of the
+ * allocation it is moved back to the start, which spreads the cost of that
+ * over term.row lines of scrolling.
+ */
+void
+tscrollring(int n)
+{
+	int i;
+
+	if (term.linebase + term.row + n > term.linecap) {
+		memmove(term.line - term.linebase, term.line, term.row * sizeof(Line));
+		term.line -= term.linebase;
+		term.linebase = 0;
+		if (term.linecap < 2 * term.row) {
+			term.linecap = 2 * term.row;
+			term.line = xrealloc(term.line, term.linecap * sizeof(Line));
+		}
+	}
+
+	for (i = 0; i < n; i++)
+		term.line[term.row + i] = term.line[i];
+	term.line += n;
+	term.linebase += n;
+}
+
+/*
+ * Moves the window back to the start of its allocation, this needs to be done
+ * before term.line is reallocated or swapped with the alternate screen.
+ */
+void
+tscrollringreset(void)
+{
+	if (term.linebase) {
+		memmove(term.line - term.linebase, term.line, term.row * sizeof(Line));
+		term.line -= term.linebase;
+		term.linebase = 0;
+	}
+	term.linecap = 0;
+}
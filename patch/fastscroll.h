@@ -0,0 +1,2 @@
+static void tscrollring(int);
+static void tscrollringreset(void);
@@ -0,0 +1,142 @@
+/*
+ * History lines are stored compressed: the attributes of the line as runs of
+ * entries in the attribute table followed by the characters as UTF-8 text.
+ * Cleared cells at the end of a line are not stored at all, so an empty line
+ * takes no memory and a short log line only a few bytes more than its text.
+ *
+ * Lines are decompressed by histline() into its cache of Glyph lines.
+ */
+struct HistLine {
+	ushort ncells;    /* stored cells, the rest of the line is cleared */
+	ushort nruns;     /* attribute runs */
+	uint32_t siz;     /* size of the allocation */
+	uint32_t attr[];  /* followed by the run lengths and the text */
+};
+
+#define HISTRUNLEN(h)  ((ushort *)&(h)->attr[(h)->nruns])
+#define HISTTEXT(h)    ((char *)&HISTRUNLEN(h)[(h)->nruns])
+#define HISTLINESIZ(nruns, textlen) \
+	(sizeof(HistLine) + (nruns) * (sizeof(uint32_t) + sizeof(ushort)) + (textlen))
+
+static struct {
+	uint32_t *attr;
+	ushort *len;
+	char *text;
+	int siz;
+} histbuf;
+static size_t histbytes;  /* memory taken up by the stored lines */
+
+static int
+histcleared(const Glyph *g)
+{
+	return g->u == ' ' && !cellattrcmp(g, &cattr.a[0].g);
+}
+
+static void
+histencode(int i, const Glyph *line, int col)
+{
+	HistLine *h = HIST(i);
+	size_t textlen = 0;
+	int x, n, r, nruns = 0, len = MIN(col, histcol);
+
+	if (h) {
+		for (r = 0; r < h->nruns; r++)
+			cellattrunref(h->attr[r], HISTRUNLEN(h)[r]);
+		histreset(i);
+	}
+
+	while (len > 0 && histcleared(&line[len - 1]))
+		len--;
+	if (!len)
+		return;
+
+	if (histcol > histbuf.siz) {
+		histbuf.siz = histcol;
+		histbuf.attr = xrealloc(histbuf.attr, histbuf.siz * sizeof(*histbuf.attr));
+		histbuf.len = xrealloc(histbuf.len, histbuf.siz * sizeof(*histbuf.len));
+		histbuf.text = xrealloc(histbuf.text, histbuf.siz * UTF_SIZ);
+	}
+
+	for (x = 0; x < len; x += n, nruns++) {
+		for (n = 1; x + n < len && !cellattrcmp(&line[x + n], &line[x]); n++)
+			;
+		histbuf.attr[nruns] = cellattr(&line[x], n);
+		histbuf.len[nruns] = n;
+	}
+	for (x = 0; x < len; x++)
+		textlen += utf8encode(line[x].u, histbuf.text + textlen);
+
+	h = xmalloc(HISTLINESIZ(nruns, textlen));
+	h->siz = HISTLINESIZ(nruns, textlen);
+	histbytes += h->siz;
+	h->ncells = len;
+	h->nruns = nruns;
+	memcpy(h->attr, histbuf.attr, nruns * sizeof(*h->attr));
+	memcpy(HISTRUNLEN(h), histbuf.len, nruns * sizeof(ushort));
+	memcpy(HISTTEXT(h), histbuf.text, textlen);
+	HIST(i) = h;
+}
+
+static void
+histdecode(int i, Glyph *line, int col)
+{
+	const HistLine *h = HIST(i);
+	const char *s;
+	Rune u;
+	int x = 0, r, n;
+
+	if (h) {
+		s = HISTTEXT(h);
+		for (r = 0; r < h->nruns; r++) {
+			for (n = HISTRUNLEN(h)[r]; n > 0 && x < col; n--, x++) {
+				s += utf8decode(s, &u, UTF_SIZ);
+				line[x] = cattr.a[h->attr[r]].g;
+				line[x].u = u;
+			}
+		}
+	}
+	for (; x < col; x++)
+		tclearglyph(&line[x], 0);
+}
+
+static int
+histchanged(int i, const Glyph *line)
+{
+	const HistLine *h = HIST(i);
+	const char *s;
+	Rune u;
+	int x = 0, r, n;
+
+	if (h) {
+		s = HISTTEXT(h);
+		for (r = 0; r < h->nruns; r++) {
+			for (n = HISTRUNLEN(h)[r]; n > 0; n--, x++) {
+				s += utf8decode(s, &u, UTF_SIZ);
+				if (line[x].u != u || cellattrcmp(&line[x], &cattr.a[h->attr[r]].g))
+					return 1;
+			}
+		}
+	}
+	for (; x < histcol; x++) {
+		if (!histcleared(&line[x]))
+			return 1;
+	}
+	return 0;
+}
+
+static void
+histreset(int i)
+{
+	if (HIST(i))
+		histbytes -= HIST(i)->siz;
+	free(HIST(i));
+	HIST(i) = NULL;
+}
+
+#if DYNAMIC_HISTORY_PATCH
+static size_t
+histmem(void)
+{
+	return histbytes + (size_t)term.histcap * sizeof(HistLine *);
+}
+#endif // DYNAMIC_HISTORY_PATCH
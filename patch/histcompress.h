@@ -0,0 +1,7 @@
+static void histencode(int, const Glyph *, int);
+static void histdecode(int, Glyph *, int);
+static int histchanged(int, const Glyph *);
+static void histreset(int);
+#if DYNAMIC_HISTORY_PATCH
+static size_t histmem(void);
+#endif // DYNAMIC_HISTORY_PATCH
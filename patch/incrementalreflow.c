@@ -0,0 +1,445 @@
+/*
+ * On a resize only the screen and as much of the history as is scrolled into
+ * view are reflowed right away. The older history lines are set aside, still
+ * at their old width, and reflowed one logical line at a time, newest first,
+ * into the top of the history ring: in slices between frames, or as soon as
+ * they are scrolled into view.
+ *
+ * The pending lines are older than any line in the ring, so the ring only
+ * gives up its oldest lines once all of them have been reflowed.
+ */
+static struct {
+	Line *line;        /* lines still to be reflowed, oldest first */
+	int *col;          /* width of each of them */
+	int n;
+	int siz;
+	int tcol;          /* width to reflow them to */
+	Line *buf;         /* reflowed lines of one logical line */
+	int bufsiz;
+	#if SIXEL_PATCH
+	ImageList *images; /* images on pending lines, reflow_y is the line */
+	#endif // SIXEL_PATCH
+} pend;
+
+static int
+pendlinelen(int p)
+{
+	int i = pend.col[p] - 1;
+
+	for (; i >= 0 && !(pend.line[p][i].mode & (ATTR_SET | ATTR_WRAP)); i--);
+	return i + 1;
+}
+
+static int
+pendwrapped(int p)
+{
+	int len = pendlinelen(p);
+
+	return len > 0 && (pend.line[p][len - 1].mode & ATTR_WRAP);
+}
+
+#if SIXEL_PATCH
+static void
+pendfreeimage(ImageList *im)
+{
+	/* delete_image() unlinks the image from term.images */
+	im->prev = NULL;
+	im->next = term.images;
+	delete_image(im);
+}
+
+static void
+pendmoveimages(int oldy, int newy)
+{
+	ImageList *im;
+
+	for (im = pend.images; im; im = im->next) {
+		if (im->reflow_y == oldy)
+			im->y = newy;
+	}
+}
+#endif // SIXEL_PATCH
+
+/*
+ * Returns 1 if n more lines fit into the history ring without dropping any.
+ */
+static int
+pendroom(int n)
+{
+	#if DYNAMIC_HISTORY_PATCH
+	while (HISTRING + n > term.histcap && histgrowring(pend.tcol))
+		;
+	#endif // DYNAMIC_HISTORY_PATCH
+	return HISTRING + n <= HISTMAX;
+}
+
+/*
+ * Reflows the pending lines [start, end), one logical line, into pend.buf.
+ *
+ * Returns the index of the last reflowed line.
+ */
+static int
+pendwrap(int start, int end)
+{
+	int col = pend.tcol, j;
+	int ox = 0, oy = start, nx = 0, ny = -1, len = 0;
+	Line line = NULL, bufline;
+
+	/* same as in treflow() */
+	do {
+		if (!nx) {
+			if (++ny == pend.bufsiz) {
+				pend.bufsiz = MAX(pend.bufsiz * 2, 16);
+				pend.buf = xrealloc(pend.buf, pend.bufsiz * sizeof(Line));
+			}
+			pend.buf[ny] = xmalloc(col * sizeof(Glyph));
+		}
+		if (!ox) {
+			line = pend.line[oy];
+			len = pendlinelen(oy);
+		}
+		bufline = pend.buf[ny];
+		if (col - nx > len - ox) {
+			memcpy(&bufline[nx], &line[ox], (len-ox) * sizeof(Glyph));
+			nx += len - ox;
+			if (len == 0 || !(line[len - 1].mode & ATTR_WRAP)) {
+				for (j = nx; j < col; j++)
+					tclearglyph(&bufline[j], 0);
+				#if SIXEL_PATCH
+				pendmoveimages(oy, ny);
+				#endif // SIXEL_PATCH
+				nx = 0;
+			} else if (nx > 0) {
+				bufline[nx - 1].mode &= ~ATTR_WRAP;
+			}
+			ox = 0, oy++;
+		} else if (col - nx == len - ox) {
+			memcpy(&bufline[nx], &line[ox], (col-nx) * sizeof(Glyph));
+			#if SIXEL_PATCH
+			pendmoveimages(oy, ny);
+			#endif // SIXEL_PATCH
+			ox = 0, oy++, nx = 0;
+		} else/* if (col - nx < len - ox) */ {
+			memcpy(&bufline[nx], &line[ox], (col-nx) * sizeof(Glyph));
+			if (bufline[col - 1].mode & ATTR_WIDE) {
+				bufline[col - 2].mode |= ATTR_WRAP;
+				tclearglyph(&bufline[col - 1], 0);
+				ox--;
+			} else {
+				bufline[col - 1].mode |= ATTR_WRAP;
+			}
+			#if SIXEL_PATCH
+			pendmoveimages(oy, ny);
+			#endif // SIXEL_PATCH
+			ox += col - nx;
+			nx = 0;
+		}
+	} while (oy < end);
+	if (nx)
+		for (j = nx; j < col; j++)
+			tclearglyph(&bufline[j], 0);
+
+	return ny;
+}
+
+#if SCROLLBACK_SPILL_PATCH
+static void
+pendspillline(Line line)
+{
+	if (spillappend(line, pend.tcol))
+		term.histf++;
+	free(line);
+}
+
+/*
+ * Spills all pending lines, followed by the reflowed lines pend.buf[0..top],
+ * as they are older than any line in the ring.
+ */
+static void
+pendspill(int top)
+{
+	Line *rest = pend.buf;
+	int restsiz = pend.bufsiz, start, end, ny, i;
+
+	pend.buf = NULL, pend.bufsiz = 0;
+	for (start = 0; start < pend.n; start = end) {
+		for (end = start + 1; end < pend.n && pendwrapped(end - 1); end++)
+			;
+		ny = pendwrap(start, end);
+		for (i = 0; i <= ny; i++)
+			pendspillline(pend.buf[i]);
+	}
+	free(pend.buf);
+	pend.buf = rest, pend.bufsiz = restsiz;
+	for (i = 0; i <= top; i++)
+		pendspillline(pend.buf[i]);
+	treflowdrop();
+}
+#endif // SCROLLBACK_SPILL_PATCH
+
+/*
+ * Reflows the newest pending logical line into the top of the history ring.
+ *
+ * Returns the number of pending lines done.
+ */
+static int
+pendreflow(void)
+{
+	int col = pend.tcol, end = pend.n, start, i, j, ny;
+	#if SIXEL_PATCH
+	int k = HISTRING;
+	Line line;
+	ImageList *im, *next, *head = NULL, *tail = NULL;
+	#endif // SIXEL_PATCH
+
+	for (start = end - 1; start > 0 && pendwrapped(start - 1); start--)
+		;
+	#if SIXEL_PATCH
+	for (im = pend.images; im; im = im->next) {
+		if (im->reflow_y >= start)
+			im->y = INT_MIN; /* unset */
+	}
+	#endif // SIXEL_PATCH
+
+	ny = pendwrap(start, end);
+	for (i = start; i < end; i++)
+		free(pend.line[i]);
+	pend.n = start;
+	#if KEYBOARDSELECT_PATCH && INDEXED_SEARCH_PATCH
+	/* the lines spilled before these move up */
+	term.histgen++;
+	#endif // INDEXED_SEARCH_PATCH
+
+	/* put the lines above the oldest line of the ring */
+	for (i = ny; i >= 0 && pendroom(1); i--) {
+		j = (term.histi - HISTRING + HISTLINES) % HISTLINES;
+		#if COMPACT_GLYPH_PATCH
+		histstore(j, pend.buf[i], col);
+		free(pend.buf[i]);
+		#else
+		free(HIST(j));
+		HIST(j) = pend.buf[i];
+		#endif // COMPACT_GLYPH_PATCH
+		term.histf++;
+	}
+
+	#if SIXEL_PATCH
+	for (im = pend.images; im; im = next) {
+		next = im->next;
+		if (im->reflow_y < start)
+			continue;
+		if (im->prev)
+			im->prev->next = im->next;
+		else
+			pend.images = im->next;
+		if (im->next)
+			im->next->prev = im->prev;
+		if (im->y == INT_MIN || im->y <= i) {
+			pendfreeimage(im);
+			continue;
+		}
+		im->y = term.scr - k - 1 - ny + im->y;
+		im->prev = tail, im->next = NULL;
+		if (tail)
+			tail->next = im;
+		else
+			head = im;
+		tail = im;
+		line = TLINE(im->y);
+		for (j = im->x; j < MIN(im->x + im->cols, col); j++) {
+			if (!(line[j].mode & ATTR_SET))
+				line[j].mode |= ATTR_SIXEL;
+		}
+	}
+	/* these are older than any image in term.images */
+	if (tail) {
+		tail->next = term.images;
+		if (term.images)
+			term.images->prev = tail;
+		term.images = head;
+	}
+	#endif // SIXEL_PATCH
+
+	/* the history is full, the rest would not fit either */
+	if (i >= 0) {
+		#if SCROLLBACK_SPILL_PATCH
+		pendspill(i);
+		#else
+		for (; i >= 0; i--)
+			free(pend.buf[i]);
+		treflowdrop();
+		#endif // SCROLLBACK_SPILL_PATCH
+	}
+
+	return end - start;
+}
+
+/*
+ * Sets aside the history lines that are not needed to fill a screen of row
+ * lines, and the lines scrolled into view, once reflowed to col cells. oce is
+ * the last line of the cursor's logical line.
+ *
+ * Returns the first line to be reflowed right away.
+ */
+int
+treflowdefer(int col, int row, int oce)
+{
+	int y, s, j, len, n = 0, split;
+	#if SIXEL_PATCH
+	ImageList *im, *next, *tail;
+	#endif // SIXEL_PATCH
+
+	pend.tcol = col;
+
+	/*
+	 * Count the reflowed lines at least needed, one logical line at a time.
+	 * The screen itself is always reflowed right away.
+	 */
+	for (y = oce; y >= -HISTRING && (y >= 0 || n < row + term.scr); y = s - 1) {
+		for (s = y, len = 0;; s--) {
+			len += tlinelen(TLINEABS(s));
+			if (s == -HISTRING || !tiswrapped(TLINEABS(s - 1)))
+				break;
+		}
+		n += MAX(1, (len + col - 1) / col);
+	}
+	split = y + 1;
+	if (split <= -HISTRING)
+		return split;
+
+	if (pend.n + split + HISTRING > pend.siz) {
+		pend.siz = MAX(pend.siz * 2, pend.n + split + HISTRING);
+		pend.line = xrealloc(pend.line, pend.siz * sizeof(Line));
+		pend.col = xrealloc(pend.col, pend.siz * sizeof(int));
+	}
+
+	#if SIXEL_PATCH
+	for (tail = pend.images; tail && tail->next; tail = tail->next)
+		;
+	for (im = term.images; im; im = next) {
+		next = im->next;
+		y = im->y - term.scr;
+		if (y < -HISTRING || y >= split)
+			continue;
+		if (im->prev)
+			im->prev->next = im->next;
+		else
+			term.images = im->next;
+		if (im->next)
+			im->next->prev = im->prev;
+		im->reflow_y = pend.n + y + HISTRING;
+		im->prev = tail, im->next = NULL;
+		if (tail)
+			tail->next = im;
+		else
+			pend.images = im;
+		tail = im;
+	}
+	#endif // SIXEL_PATCH
+
+	for (y = -HISTRING; y < split; y++) {
+		j = (term.histi + y + 1 + HISTLINES) % HISTLINES;
+		#if COMPACT_GLYPH_PATCH
+		pend.line[pend.n] = xmalloc(term.col * sizeof(Glyph));
+		memcpy(pend.line[pend.n], histline(j), term.col * sizeof(Glyph));
+		#else
+		pend.line[pend.n] = HIST(j);
+		HIST(j) = NULL;
+		#endif // COMPACT_GLYPH_PATCH
+		pend.col[pend.n++] = term.col;
+	}
+
+	return split;
+}
+
+/*
+ * Reflows at least n pending lines, if there are any.
+ *
+ * Returns 1 if there were pending lines.
+ */
+int
+treflowstep(int n)
+{
+	int pending = pend.n > 0;
+
+	while (pend.n > 0 && n > 0)
+		n -= pendreflow();
+	return pending;
+}
+
+int
+treflowpending(void)
+{
+	return pend.n > 0;
+}
+
+/*
+ * Reflows pending lines until the history ring holds at least n lines.
+ */
+void
+treflowneed(int n)
+{
+	while (pend.n > 0 && HISTRING < n)
+		pendreflow();
+}
+
+/*
+ * Makes room for n more lines in the history. The pending lines are reflowed
+ * first if the oldest lines of the ring would otherwise have to go.
+ */
+void
+treflowreserve(int n)
+{
+	if (pend.n > 0 && !pendroom(n))
+		treflowfinish();
+}
+
+void
+treflowfinish(void)
+{
+	while (pend.n > 0)
+		pendreflow();
+}
+
+void
+treflowdrop(void)
+{
+	int i;
+
+	for (i = 0; i < pend.n; i++)
+		free(pend.line[i]);
+	pend.n = 0;
+	#if SIXEL_PATCH
+	treflowdropimages();
+	#endif // SIXEL_PATCH
+}
+
+#if OSC8_PATCH
+/*
+ * Counts the hyperlinks of the pending lines, see linkcount().
+ */
+void
+treflowmarklinks(void)
+{
+	int i, x;
+
+	for (i = 0; i < pend.n; i++) {
+		for (x = 0; x < pend.col[i]; x++)
+			linkmark(pend.line[i][x].link);
+	}
+}
+#endif // OSC8_PATCH
+
+#if SIXEL_PATCH
+void
+treflowdropimages(void)
+{
+	ImageList *im, *next;
+
+	for (im = pend.images; im; im = next) {
+		next = im->next;
+		pendfreeimage(im);
+	}
+	pend.images = NULL;
+}
+#endif // SIXEL_PATCH
@@ -0,0 +1,13 @@
+int treflowdefer(int, int, int);
+int treflowstep(int);
+int treflowpending(void);
+void treflowneed(int);
+void treflowreserve(int);
+void treflowfinish(void);
+void treflowdrop(void);
+#if OSC8_PATCH
+void treflowmarklinks(void);
+#endif // OSC8_PATCH
+#if SIXEL_PATCH
+void treflowdropimages(void);
+#endif // SIXEL_PATCH
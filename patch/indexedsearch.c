@@ -0,0 +1,484 @@
+/*
+ * A line gets a summary as it is saved to the history: a 256-bit Bloom filter
+ * of its lowercased characters and pairs of characters, plus its first and
+ * last character for the pairs that span wrapped lines. The summaries are
+ * cached by serial number, which is the number of lines saved to the history
+ * before the line, and hold until term.histgen changes. Lines rewritten since,
+ * by a reflow, get theirs again the first time they are searched.
+ *
+ * A match can only start on a line whose logical line has all characters and
+ * pairs of the search string, so the other lines are skipped without being
+ * decoded. The visible lines are highlighted right away; the rest of the
+ * history is highlighted newest first in slices between frames, see
+ * searchslice.
+ *
+ * Once that is done, the lines with highlights are kept for the next search.
+ * If its search string has the previous one in it, a match can only start on
+ * those logical lines, or on the lines saved to the history since.
+ */
+#define KBDS_INDEXMAX (1 << 18)
+
+typedef struct {
+	uint serial;       /* serial + 1, or 0 */
+	uint gen;
+	Rune first;        /* first and last character, lowercased */
+	Rune last;
+	int wrapped;
+	uint64_t bits[4];
+} KIndex;
+
+static struct {
+	KIndex *e;
+	int siz;           /* a power of 2 */
+	uint64_t query[4];
+	int memo;          /* the logical line below was checked */
+	uint top, bot;
+	int cand;
+	int scanning;      /* lines left to highlight */
+	uint scan;         /* next line to highlight */
+	uint scangen;
+	int scanscr;       /* scroll position the visible lines were done at */
+	uint *hl;          /* lines with highlights */
+	int nhl;
+	int hlsiz;
+	uint hlgen;
+	int complete;      /* the whole history has been highlighted */
+	Rune *q;           /* the search string the highlights are for */
+	int nq, qsiz;
+	int qregex;
+	uint qseq;         /* term.histseq at the time */
+
+	/* the highlights of the last complete search */
+	int prevok;
+	uint *prev;        /* the lines with highlights, oldest first */
+	int nprev, prevsiz;
+	uint prevgen, prevseq;
+	Rune *prevq;
+	int nprevq, prevqsiz;
+	int narrow;        /* the search string has prevq in it */
+} kidx;
+
+static uint
+kbds_serial(int y)
+{
+	return term.histseq + y - term.scr;
+}
+
+static int
+kbds_serialy(uint s)
+{
+	return (int)(s - term.histseq) + term.scr;
+}
+
+static void
+kbds_bitset(uint64_t *bits, Rune a, Rune b)
+{
+	uint32_t h = a * 0x9e3779b1u ^ b * 0x85ebca77u;
+
+	h = (h ^ (h >> 16)) * 0xc2b2ae3du >> 24;
+	bits[h >> 6] |= 1ULL << (h & 63);
+}
+
+/*
+ * towlower(), without the call for ASCII, as every line saved to the history
+ * goes through here.
+ */
+static inline Rune
+kbds_lower(Rune u)
+{
+	if (u < 128)
+		return BETWEEN(u, 'A', 'Z') ? u + ('a' - 'A') : u;
+	return towlower(u);
+}
+
+static void
+kbds_summarize(Line line, KIndex *k)
+{
+	int x, i, n, len = tlinelen(line);
+	Rune u;
+
+	memset(k->bits, 0, sizeof(k->bits));
+	k->first = len > 0 ? kbds_lower(line[0].u) : 0;
+	k->last = 0;
+	for (x = n = 0; x < len; x++) {
+		u = kbds_lower(line[x].u);
+		if (line[x].mode & ATTR_WDUMMY) {
+			if (!u)
+				continue;
+			/* a match may start here too, the search skips dummies after it */
+			kbds_bitset(k->bits, u, 0);
+			for (i = x + 1; i < len && (line[i].mode & ATTR_WDUMMY); i++)
+				;
+			if (i < len)
+				kbds_bitset(k->bits, u, kbds_lower(line[i].u));
+			else
+				memset(k->bits, 0xff, sizeof(k->bits));
+			continue;
+		}
+		kbds_bitset(k->bits, u, 0);
+		if (n++)
+			kbds_bitset(k->bits, k->last, u);
+		k->last = u;
+	}
+	k->wrapped = len > 0 && (line[len - 1].mode & ATTR_WRAP);
+}
+
+/*
+ * Makes room for the summaries of need lines, keeping the ones there are.
+ */
+static void
+kbds_indexgrow(int need)
+{
+	KIndex *e;
+	int i, siz;
+
+	need = MIN(need, KBDS_INDEXMAX);
+	if (kidx.siz >= need)
+		return;
+	for (siz = MAX(kidx.siz, 1024); siz < need; siz *= 2)
+		;
+	e = xmalloc(siz * sizeof(KIndex));
+	memset(e, 0, siz * sizeof(KIndex));
+	/* serials apart by less than the old size stay apart */
+	for (i = 0; i < kidx.siz; i++) {
+		if (kidx.e[i].serial)
+			e[(kidx.e[i].serial - 1) & (siz - 1)] = kidx.e[i];
+	}
+	free(kidx.e);
+	kidx.e = e;
+	kidx.siz = siz;
+}
+
+/*
+ * Summarizes the line saved to the history as line number serial, in
+ * tscrollup().
+ */
+void
+kbds_indexadd(Line line, uint serial)
+{
+	KIndex *k;
+
+	kbds_indexgrow(term.histf + 1);
+	k = &kidx.e[serial & (kidx.siz - 1)];
+	kbds_summarize(line, k);
+	k->serial = serial + 1;
+	k->gen = term.histgen;
+}
+
+/*
+ * Returns the summary of line y. The summary of a screen line is only valid
+ * until the next call.
+ */
+static KIndex *
+kbds_index(int y)
+{
+	static KIndex screen;
+	KIndex *k;
+	uint s = kbds_serial(y);
+
+	if (IS_SET(MODE_ALTSCREEN) || y - term.scr >= 0) {
+		kbds_summarize(TLINE(y), &screen);
+		return &screen;
+	}
+
+	kbds_indexgrow(term.histf);
+	k = &kidx.e[s & (kidx.siz - 1)];
+	if (k->serial != s + 1 || k->gen != term.histgen) {
+		kbds_summarize(TLINE(y), k);
+		k->serial = s + 1;
+		k->gen = term.histgen;
+	}
+	return k;
+}
+
+/*
+ * Sets up the search string for kbds_iscandidate().
+ */
+void
+kbds_indexquery(void)
+{
+	Rune u, prev = 0;
+	int i, n;
+	#if REGEX_SEARCH_PATCH
+	Rune must[32];
+	#endif // REGEX_SEARCH_PATCH
+
+	memset(kidx.query, 0, sizeof(kidx.query));
+	kidx.memo = 0;
+	kidx.narrow = 0;
+	kidx.qseq = term.histseq;
+	if (kbds_searchlen > kidx.qsiz) {
+		kidx.qsiz = kbds_searchlen;
+		kidx.q = xrealloc(kidx.q, kidx.qsiz * sizeof(Rune));
+	}
+	for (i = kidx.nq = 0; i < kbds_searchlen; i++) {
+		if (!(kbds_searchstr[i].mode & ATTR_WDUMMY))
+			kidx.q[kidx.nq++] = kbds_searchstr[i].u;
+	}
+	#if REGEX_SEARCH_PATCH
+	/* only the characters every match has */
+	if ((kidx.qregex = kbds_isregex())) {
+		for (i = 0, n = kbds_rerequired(must, LEN(must)); i < n; i++)
+			kbds_bitset(kidx.query, towlower(must[i]), 0);
+		return;
+	}
+	#endif // REGEX_SEARCH_PATCH
+	for (i = n = 0; i < kbds_searchlen; i++) {
+		if (kbds_searchstr[i].mode & ATTR_WDUMMY)
+			continue;
+		u = towlower(kbds_searchstr[i].u);
+		kbds_bitset(kidx.query, u, 0);
+		if (n++)
+			kbds_bitset(kidx.query, prev, u);
+		prev = u;
+	}
+
+	/* where the search string has the previous one, it is matched too, and
+	 * the same way: either it is all lower case or so is the previous one */
+	if (!kidx.prevok || kidx.prevgen != term.histgen || IS_SET(MODE_ALTSCREEN))
+		return;
+	for (i = 0; i + kidx.nprevq <= kidx.nq; i++) {
+		if (!memcmp(kidx.q + i, kidx.prevq, kidx.nprevq * sizeof(Rune))) {
+			kidx.narrow = 1;
+			break;
+		}
+	}
+}
+
+/*
+ * Returns 1 if the previous search highlighted any of the lines from serial
+ * top to bot.
+ */
+static int
+kbds_inprev(uint top, uint bot)
+{
+	int lo = 0, hi = kidx.nprev, mid;
+
+	/* serials can go below 0 after a reflow, so compare them to prevseq */
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if ((int)(kidx.prev[mid] - kidx.prevseq) < (int)(top - kidx.prevseq))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < kidx.nprev && (int)(kidx.prev[lo] - kidx.prevseq) <= (int)(bot - kidx.prevseq);
+}
+
+/*
+ * Returns 0 if no match of the search string starts on line y.
+ */
+int
+kbds_iscandidate(int y)
+{
+	uint64_t bits[4] = { 0 };
+	uint s = kbds_serial(y);
+	Rune last = 0;
+	KIndex *k;
+	int top, bot, i;
+
+	if (kidx.memo && s - kidx.top <= kidx.bot - kidx.top)
+		return kidx.cand;
+
+	/* a match can go on over wrapped lines, so check the whole logical line */
+	for (top = y; top > kbds_top() && kbds_index(top - 1)->wrapped; top--)
+		;
+	for (bot = y; bot < kbds_bot() && kbds_index(bot)->wrapped; bot++)
+		;
+	for (i = top; i <= bot; i++) {
+		k = kbds_index(i);
+		if (i > top)
+			kbds_bitset(bits, last, k->first);
+		bits[0] |= k->bits[0];
+		bits[1] |= k->bits[1];
+		bits[2] |= k->bits[2];
+		bits[3] |= k->bits[3];
+		last = k->last;
+	}
+
+	kidx.memo = 1;
+	kidx.top = kbds_serial(top);
+	kidx.bot = kbds_serial(bot);
+	kidx.cand = 1;
+	for (i = 0; i < 4; i++) {
+		if ((bits[i] & kidx.query[i]) != kidx.query[i])
+			kidx.cand = 0;
+	}
+	/* the lines saved since the previous search were not searched then */
+	if (kidx.cand && kidx.narrow && kidx.prevgen == term.histgen &&
+	    (int)(kidx.bot - kidx.prevseq) < 0)
+		kidx.cand = kbds_inprev(kidx.top, kidx.bot);
+	return kidx.cand;
+}
+
+/*
+ * Remembers that line y has highlights, for kbds_clearmarked().
+ */
+void
+kbds_markline(int y)
+{
+	uint s = kbds_serial(y);
+
+	if (IS_SET(MODE_ALTSCREEN) || (kidx.nhl > 0 && kidx.hl[kidx.nhl - 1] == s))
+		return;
+	if (kidx.nhl == kidx.hlsiz) {
+		kidx.hlsiz = MAX(kidx.hlsiz * 2, 64);
+		kidx.hl = xrealloc(kidx.hl, kidx.hlsiz * sizeof(*kidx.hl));
+	}
+	kidx.hl[kidx.nhl++] = s;
+}
+
+static int
+kbds_serialcmp(const void *a, const void *b)
+{
+	int x = *(const uint *)a - kidx.prevseq, y = *(const uint *)b - kidx.prevseq;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Keeps the lines with highlights of a complete search, for narrowing down the
+ * next one.
+ */
+static void
+kbds_keepmarked(void)
+{
+	uint *t;
+	int n;
+
+	kidx.prevok = kidx.complete && !kidx.qregex && !IS_SET(MODE_ALTSCREEN) &&
+		kidx.hlgen == term.histgen;
+	kidx.complete = 0;
+	if (!kidx.prevok)
+		return;
+
+	t = kidx.prev, kidx.prev = kidx.hl, kidx.hl = t;
+	n = kidx.prevsiz, kidx.prevsiz = kidx.hlsiz, kidx.hlsiz = n;
+	kidx.nprev = kidx.nhl;
+	kidx.prevgen = kidx.hlgen;
+	kidx.prevseq = kidx.qseq;
+	qsort(kidx.prev, kidx.nprev, sizeof(uint), kbds_serialcmp);
+
+	if (kidx.nq > kidx.prevqsiz) {
+		kidx.prevqsiz = kidx.nq;
+		kidx.prevq = xrealloc(kidx.prevq, kidx.prevqsiz * sizeof(Rune));
+	}
+	memcpy(kidx.prevq, kidx.q, kidx.nq * sizeof(Rune));
+	kidx.nprevq = kidx.nq;
+}
+
+/*
+ * Clears the highlights on the screen and on the marked history lines.
+ *
+ * Returns 0 if the history has been rewritten since, and all lines have to be
+ * cleared.
+ */
+int
+kbds_clearmarked(void)
+{
+	int i, x, y;
+	Line line;
+
+	kidx.scanning = 0;
+	if (IS_SET(MODE_ALTSCREEN) || kidx.hlgen != term.histgen) {
+		kbds_keepmarked();
+		kidx.nhl = 0;
+		kidx.hlgen = term.histgen;
+		return 0;
+	}
+
+	for (i = 0; i < kidx.nhl; i++) {
+		y = kbds_serialy(kidx.hl[i]) - term.scr;
+		if (y < -term.histf || y >= 0)
+			continue;
+		line = TLINEABS(y);
+		for (x = 0; x < term.col; x++)
+			line[x].mode &= ~ATTR_HIGHLIGHT;
+	}
+	kbds_keepmarked();
+	kidx.nhl = 0;
+
+	for (y = 0; y < term.row; y++) {
+		line = TLINEABS(y);
+		for (x = 0; x < term.col; x++)
+			line[x].mode &= ~ATTR_HIGHLIGHT;
+	}
+	return 1;
+}
+
+static void
+kbds_highlightline(int y)
+{
+	KCursor c;
+
+	if (!kbds_maymatch(y))
+		return;
+	c.y = y;
+	c.line = TLINE(y);
+	c.len = tlinelen(c.line);
+	for (c.x = 0; c.x < c.len; c.x++)
+		kbds_ismatch(c);
+	if (y >= 0 && y < term.row)
+		term.dirty[y] = 1;
+}
+
+/*
+ * Highlights the matches in the rest of the history in kbds_searchstep().
+ */
+void
+kbds_searchlater(void)
+{
+	kidx.scanning = !IS_SET(MODE_ALTSCREEN);
+	kidx.complete = 0;
+	kidx.scan = kbds_serial(kbds_bot());
+	kidx.scangen = term.histgen;
+	kidx.scanscr = term.scr;
+}
+
+/*
+ * Highlights the matches in the next n lines, newest first, and in the lines
+ * that have been scrolled into view since.
+ *
+ * Returns 1 if there were lines left to highlight.
+ */
+int
+kbds_searchstep(int n)
+{
+	int y;
+
+	if (!kidx.scanning)
+		return 0;
+	if (!kbds_in_use || !kbds_searchlen || IS_SET(MODE_ALTSCREEN)) {
+		kidx.scanning = 0;
+		return 0;
+	}
+
+	kidx.memo = 0;
+	#if REGEX_SEARCH_PATCH
+	kbds_recompile();
+	#endif // REGEX_SEARCH_PATCH
+	if (kidx.scangen != term.histgen)
+		kbds_searchlater();
+	if (kidx.scanscr != term.scr) {
+		for (y = 0; y < term.row; y++)
+			kbds_highlightline(y);
+		kidx.scanscr = term.scr;
+	}
+	for (; n > 0; n--, kidx.scan--) {
+		if ((y = kbds_serialy(kidx.scan)) < kbds_top()) {
+			kidx.scanning = 0;
+			kidx.complete = 1;
+			break;
+		}
+		kbds_highlightline(y);
+	}
+	/* decoding the history may have moved the cursor line out of its cache */
+	kbds_c.line = TLINE(kbds_c.y);
+	return 1;
+}
+
+int
+kbds_searchpending(void)
+{
+	return kidx.scanning;
+}
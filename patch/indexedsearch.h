@@ -0,0 +1,8 @@
+void kbds_indexadd(Line line, uint serial);
+void kbds_indexquery(void);
+int kbds_iscandidate(int y);
+void kbds_markline(int y);
+int kbds_clearmarked(void);
+void kbds_searchlater(void);
+int kbds_searchstep(int n);
+int kbds_searchpending(void);
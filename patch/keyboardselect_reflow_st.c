@@ -29,12 +29,16 @@ static int kbds_finddir, kbds_findtill;
 static Glyph *kbds_searchstr;
 static Rune kbds_findchar;
 static KCursor kbds_c, kbds_oc;
+#if REGEX_SEARCH_PATCH
+static int kbds_regex;
+#endif // REGEX_SEARCH_PATCH
 
 void
 kbds_drawstatusbar(int y)
 {
 	static char *modes[] = { " MOVE ", "", " SELECT ", " RSELECT ", " LSELECT ",
-	                         " SEARCH FW ", " SEARCH BW ", " FIND FW ", " FIND BW " };
+	                         " SEARCH FW ", " SEARCH BW ", " FIND FW ", " FIND BW ",
+	                         " REGEX FW ", " REGEX BW " };
 	static char quant[20] = { ' ' };
 	static Glyph g;
 	int i, n, m;
@@ -49,7 +53,11 @@ kbds_drawstatusbar(int y)
 
 	if (y == 0) {
 		if (kbds_issearchmode())
+			#if REGEX_SEARCH_PATCH
+			m = (kbds_regex ? 9 : 5) + (kbds_searchdir < 0 ? 1 : 0);
+			#else
 			m = 5 + (kbds_searchdir < 0 ? 1 : 0);
+			#endif // REGEX_SEARCH_PATCH
 		else if (kbds_mode & KBDS_MODE_FIND)
 			m = 7 + (kbds_finddir < 0 ? 1 : 0);
 		else if (kbds_mode & KBDS_MODE_SELECT)
@@ -116,7 +124,11 @@ kbds_pasteintosearch(const char *data, int len, int append)
 			if (u > 0x1f && kbds_searchlen < term.col-2) {
 				kbds_searchstr[kbds_searchlen].u = u;
 				kbds_searchstr[kbds_searchlen++].mode = ATTR_NULL;
+				#if UNICODE_WIDTH_PATCH
+				if (unicodewidth(u) > 1) {
+				#else
 				if (wcwidth(u) > 1) {
+				#endif // UNICODE_WIDTH_PATCH
 					kbds_searchstr[kbds_searchlen-1].mode = ATTR_WIDE;
 					if (kbds_searchlen < term.col-2) {
 						kbds_searchstr[kbds_searchlen].u = 0;
@@ -205,6 +217,13 @@ kbds_clearhighlights(void)
 	int x, y;
 	Line line;
 
+	#if INDEXED_SEARCH_PATCH
+	if (kbds_clearmarked()) {
+		tfulldirt();
+		return;
+	}
+	#endif // INDEXED_SEARCH_PATCH
+
 	for (y = (IS_SET(MODE_ALTSCREEN) ? 0 : -term.histf); y < term.row; y++) {
 		line = TLINEABS(y);
 		for (x = 0; x < term.col; x++)
@@ -278,6 +297,14 @@ kbds_ismatch(KCursor c)
 	KCursor m = c;
 	int i, next;
 
+	#if REGEX_SEARCH_PATCH
+	if (kbds_isregex()) {
+		if (!(next = kbds_rematch(c.x, c.y)))
+			return 0;
+		/* reading a long logical line may have moved this one out of a history cache */
+		m.line = TLINE(m.y);
+	} else {
+	#endif // REGEX_SEARCH_PATCH
 	if (c.x + kbds_searchlen > c.len && (!kbds_iswrapped(&c) || c.y >= kbds_bot()))
 		return 0;
 
@@ -289,16 +316,40 @@ kbds_ismatch(KCursor c)
 		    (!kbds_searchcase && kbds_searchstr[i].u != towlower(c.line[c.x].u)))
 			return 0;
 	}
-
-	for (i = 0; i < kbds_searchlen; i++) {
-		if (!(kbds_searchstr[i].mode & ATTR_WDUMMY)) {
-			m.line[m.x].mode |= ATTR_HIGHLIGHT;
-			kbds_moveforward(&m, 1, KBDS_WRAP_LINE);
-		}
+	#if REGEX_SEARCH_PATCH
+	}
+	#endif // REGEX_SEARCH_PATCH
+
+	/* next is the number of characters matched */
+	for (i = 0; i < next; i++) {
+		m.line[m.x].mode |= ATTR_HIGHLIGHT;
+		#if INDEXED_SEARCH_PATCH
+		kbds_markline(m.y);
+		#endif // INDEXED_SEARCH_PATCH
+		kbds_moveforward(&m, 1, KBDS_WRAP_LINE);
 	}
 	return 1;
 }
 
+#if INDEXED_SEARCH_PATCH || REGEX_SEARCH_PATCH
+/*
+ * Returns 0 if no match starts on line y.
+ */
+static int
+kbds_maymatch(int y)
+{
+	#if INDEXED_SEARCH_PATCH
+	if (!kbds_iscandidate(y))
+		return 0;
+	#endif // INDEXED_SEARCH_PATCH
+	#if REGEX_SEARCH_PATCH
+	if (kbds_isregex() && !kbds_rehasmatch(y))
+		return 0;
+	#endif // REGEX_SEARCH_PATCH
+	return 1;
+}
+#endif // INDEXED_SEARCH_PATCH | REGEX_SEARCH_PATCH
+
 int
 kbds_searchall(void)
 {
@@ -308,38 +359,69 @@ kbds_searchall(void)
 	if (!kbds_searchlen)
 		return 0;
 
+	#if REGEX_SEARCH_PATCH
+	kbds_recompile();
+	#endif // REGEX_SEARCH_PATCH
+	#if INDEXED_SEARCH_PATCH
+	/* the visible lines right away, the rest of the history between frames */
+	kbds_indexquery();
+	for (c.y = 0; c.y < term.row; c.y++) {
+	#else
 	for (c.y = kbds_top(); c.y <= kbds_bot(); c.y++) {
+	#endif // INDEXED_SEARCH_PATCH
+		#if INDEXED_SEARCH_PATCH || REGEX_SEARCH_PATCH
+		if (!kbds_maymatch(c.y))
+			continue;
+		#endif // INDEXED_SEARCH_PATCH | REGEX_SEARCH_PATCH
 		c.line = TLINE(c.y);
 		c.len = tlinelen(c.line);
 		for (c.x = 0; c.x < c.len; c.x++)
 			count += kbds_ismatch(c);
 	}
+	#if INDEXED_SEARCH_PATCH
+	kbds_searchlater();
+	#endif // INDEXED_SEARCH_PATCH
 	tfulldirt();
 
 	return count;
 }
 
-void
+int
 kbds_searchnext(int dir)
 {
 	KCursor c = kbds_c, n = kbds_c;
-	int wrapped = 0;
+	int wrapped = 0, found = 0;
 
 	if (!kbds_searchlen) {
 		kbds_quant = 0;
-		return;
+		return 0;
 	}
 
+	/* reading the history may have evicted the line from a history cache */
+	c.line = TLINE(c.y);
 	if (dir < 0 && c.x > c.len)
 		c.x = c.len;
+	#if REGEX_SEARCH_PATCH
+	kbds_recompile();
+	#endif // REGEX_SEARCH_PATCH
+	#if INDEXED_SEARCH_PATCH
+	kbds_indexquery();
+	#endif // INDEXED_SEARCH_PATCH
 
 	for (kbds_quant = MAX(kbds_quant, 1); kbds_quant > 0;) {
 		if (!kbds_moveforward(&c, dir, KBDS_WRAP_LINE)) {
+			#if INDEXED_SEARCH_PATCH || REGEX_SEARCH_PATCH
+			/* skip the lines no match starts on */
+			do {
+			#endif // INDEXED_SEARCH_PATCH | REGEX_SEARCH_PATCH
 			c.y += dir;
 			if (c.y < kbds_top())
 				c.y = kbds_bot(), wrapped++;
 			else if (c.y > kbds_bot())
 				c.y = kbds_top(), wrapped++;
+			#if INDEXED_SEARCH_PATCH || REGEX_SEARCH_PATCH
+			} while (wrapped <= 1 && !kbds_maymatch(c.y));
+			#endif // INDEXED_SEARCH_PATCH | REGEX_SEARCH_PATCH
 			if (wrapped > 1)
 				break;;
 			c.line = TLINE(c.y);
@@ -350,11 +432,16 @@ kbds_searchnext(int dir)
 		if (kbds_ismatch(c)) {
 			n = c;
 			kbds_quant--;
+			found++;
 		}
+		#if REGEX_SEARCH_PATCH
+		c.line = TLINE(c.y);
+		#endif // REGEX_SEARCH_PATCH
 	}
 
 	kbds_moveto(n.x, n.y);
 	kbds_quant = 0;
+	return found;
 }
 
 void
@@ -474,12 +561,23 @@ kbds_keyboardhandler(KeySym ksym, char *buf, int len, int forcequit)
 					}
 				}
 				count = kbds_searchall();
+				#if INDEXED_SEARCH_PATCH
+				/* only the visible lines have been searched so far */
+				count += kbds_searchnext(kbds_searchdir);
+				#else
 				kbds_searchnext(kbds_searchdir);
+				#endif // INDEXED_SEARCH_PATCH
 				kbds_selecttext();
 				kbds_setmode(kbds_mode & ~KBDS_MODE_SEARCH);
 				if (count == 0 && kbds_directsearch)
 					ksym = XK_Escape;
 				break;
+			#if REGEX_SEARCH_PATCH
+			case XK_Tab:
+				kbds_regex = !kbds_regex;
+				term.dirty[0] = 1;
+				break;
+			#endif // REGEX_SEARCH_PATCH
 			case XK_BackSpace:
 				if (kbds_searchlen) {
 					kbds_searchlen--;
@@ -493,7 +591,11 @@ kbds_keyboardhandler(KeySym ksym, char *buf, int len, int forcequit)
 				utf8decode(buf, &u, len);
 				kbds_searchstr[kbds_searchlen].u = u;
 				kbds_searchstr[kbds_searchlen++].mode = ATTR_NULL;
+				#if UNICODE_WIDTH_PATCH
+				if (unicodewidth(u) > 1) {
+				#else
 				if (wcwidth(u) > 1) {
+				#endif // UNICODE_WIDTH_PATCH
 					kbds_searchstr[kbds_searchlen-1].mode = ATTR_WIDE;
 					if (kbds_searchlen < term.col-2) {
 						kbds_searchstr[kbds_searchlen].u = 0;
@@ -529,8 +631,15 @@ kbds_keyboardhandler(KeySym ksym, char *buf, int len, int forcequit)
 
 	switch (ksym) {
 	case -1:
+		#if INCREMENTAL_REFLOW_PATCH
+		/* moving and searching covers the whole history */
+		treflowfinish();
+		#endif // INCREMENTAL_REFLOW_PATCH
 		kbds_searchstr = xmalloc(term.col * sizeof(Glyph));
 		kbds_in_use = 1;
+		#if REGEX_SEARCH_PATCH
+		kbds_regex = 0;
+		#endif // REGEX_SEARCH_PATCH
 		kbds_moveto(term.c.x, term.c.y);
 		kbds_oc = kbds_c;
 		kbds_setmode(KBDS_MODE_MOVE);
@@ -1,14 +1,13 @@
-#if !REFLOW_PATCH
-#if SCROLLBACK_PATCH
+#if REFLOW_PATCH || SCROLLBACK_PATCH
 #define TLINEURL(y) TLINE(y)
 #else
 #define TLINEURL(y) term.line[y]
-#endif // SCROLLBACK_PATCH
-#endif // REFLOW_PATCH
+#endif // REFLOW_PATCH | SCROLLBACK_PATCH
 
 int url_x1, url_y1, url_x2, url_y2 = -1;
 int url_draw, url_click, url_maxcol;
 
+#if !(REFLOW_PATCH && URL_CACHE_PATCH)
 static int
 isvalidurlchar(Rune u)
 {
@@ -52,6 +51,7 @@ findeowl(int row)
 	return -1;
 }
 #endif // REFLOW_PATCH
+#endif // URL_CACHE_PATCH
 
 void
 clearurl(void)
@@ -61,7 +61,101 @@ clearurl(void)
 	url_y2 = -1;
 }
 
-#if REFLOW_PATCH
+#if OSC8_PATCH || (REFLOW_PATCH && URL_CACHE_PATCH)
+/* underline url (see xdrawglyphfontspecs() in x.c) */
+static void
+underlineurl(int x1, int y1, int x2, int y2, int maxcol)
+{
+	/* the url is already underlined, unless its lines are about to be drawn */
+	if (url_y2 >= 0 && x1 == url_x1 && y1 == url_y1 && x2 == url_x2 && y2 == url_y2) {
+		for (; y1 <= y2; y1++)
+			url_draw |= term.dirty[y1];
+		return;
+	}
+
+	clearurl();
+	url_x1 = x1;
+	url_x2 = x2;
+	url_y1 = y1;
+	url_y2 = y2;
+	url_maxcol = maxcol;
+	url_draw = 1;
+	for (; y1 <= y2; y1++)
+		term.dirty[y1] = 1;
+}
+#endif // OSC8_PATCH | URL_CACHE_PATCH
+
+#if OSC8_PATCH
+/* find the OSC 8 hyperlink at col, row, which goes on for as long as the cells
+ * next to it link to the same uri */
+static char *
+detectlink(int col, int row, int draw)
+{
+	uint32_t link = TLINEURL(row)[col].link;
+	int x1 = col, y1 = row, x2 = col, y2 = row;
+	char *uri;
+
+	if (!link || !(uri = linkuri(link)))
+		return NULL;
+
+	if (!draw)
+		return uri;
+
+	for (;;) {
+		if (x1 > 0 && TLINEURL(y1)[x1-1].link == link)
+			x1--;
+		else if (x1 == 0 && y1 > 0 && TLINEURL(y1-1)[term.col-1].link == link)
+			x1 = term.col-1, y1--;
+		else
+			break;
+	}
+	for (;;) {
+		if (x2 < term.col-1 && TLINEURL(y2)[x2+1].link == link)
+			x2++;
+		else if (x2 == term.col-1 && y2 < term.row-1 && TLINEURL(y2+1)[0].link == link)
+			x2 = 0, y2++;
+		else
+			break;
+	}
+
+	underlineurl(x1, y1, x2, y2, (y1 < y2) ? term.col-1 : x2);
+	return uri;
+}
+#endif // OSC8_PATCH
+
+#if REFLOW_PATCH && URL_CACHE_PATCH
+char *
+detecturl(int col, int row, int draw)
+{
+	UrlSpan u;
+	int x1, y1, x2, y2, maxcol;
+	#if OSC8_PATCH
+	char *link;
+
+	if ((link = detectlink(col, row, draw)))
+		return link;
+	#endif // OSC8_PATCH
+
+	if (!urlat(col, row, &u)) {
+		if (draw)
+			clearurl();
+		url_maxcol = 0;
+		return NULL;
+	}
+
+	if (!draw)
+		return urltext(&u);
+
+	x1 = (u.y1 >= 0) ? u.x1 : 0;
+	y1 = MAX(u.y1, 0);
+	maxcol = (u.y1 < u.y2) ? term.col - 1 : u.x2;
+	x2 = (u.y2 < term.row) ? u.x2 : maxcol;
+	y2 = MIN(u.y2, term.row-1);
+
+	underlineurl(x1, y1, x2, y2, maxcol);
+	return urltext(&u);
+}
+#elif REFLOW_PATCH
 char *
 detecturl(int col, int row, int draw)
 {
@@ -72,6 +166,12 @@ detecturl(int col, int row, int draw)
 	int row_start = row, col_start = col;
 	int minrow = tisaltscr() ? 0 : term.scr - term.histf;
 	int maxrow = tisaltscr() ? term.row - 1 : term.scr + term.row - 1;
+	#if OSC8_PATCH
+	char *link;
+
+	if ((link = detectlink(col, row, draw)))
+		return link;
+	#endif // OSC8_PATCH
 
 	/* clear previously underlined url */
 	if (draw)
@@ -156,6 +256,12 @@ detecturl(int col, int row, int draw)
 	#else
 	int minrow = 0, maxrow = term.row - 1;
 	#endif // SCROLLBACK_PATCH
+	#if OSC8_PATCH
+	char *link;
+
+	if ((link = detectlink(col, row, draw)))
+		return link;
+	#endif // OSC8_PATCH
 	url_maxcol = 0;
 
 	/* clear previously underlined url */
@@ -14,6 +14,14 @@ scrolltoprompt(const Arg *arg)
 	if (!dy || tisaltscr())
 		return;
 
+	#if REFLOW_PATCH && INCREMENTAL_REFLOW_PATCH
+	/* the prompt may be in the part of the history not reflowed yet */
+	if (dy < 0) {
+		treflowfinish();
+		top = term.scr - term.histf;
+	}
+	#endif // INCREMENTAL_REFLOW_PATCH
+
 	for (y = dy; y >= top && y <= bot; y += dy) {
 		for (line = TLINE(y), x = 0; x < term.col; x++) {
 			if (line[x].mode & ATTR_FTCS_PROMPT)
@@ -0,0 +1,232 @@
+/*
+ * OSC 8 hyperlinks. Every cell holds the id of the link it is part of, or 0.
+ * The uris are interned in a table, so a link that is repeated on thousands of
+ * lines is only stored once.
+ *
+ * Cells are written and copied in too many places to count references as it
+ * happens. Instead the references are counted by going over the screens and
+ * the history once the table has grown to twice the entries that were in use
+ * after the last count, and the entries of links that have left the history
+ * are freed then. An id is the index of its entry + 1 with the generation of
+ * the entry in the top bits, so a stray id that was not counted, like the one
+ * of a saved cursor, can not pick up the uri of a later link.
+ */
+#define LINK_NONE   UINT32_MAX
+#define LINKMAX     (1 << 24)
+#define LINKINDEX(l) (((l) & (LINKMAX - 1)) - 1)
+#define LINKGEN(l)   ((l) >> 24)
+
+typedef struct {
+	char *uri;      /* NULL if the entry is free */
+	char *id;       /* id parameter, or an empty string */
+	uint32_t hash;
+	uint32_t next;  /* next entry in the hash chain or the free list */
+	uint32_t refs;  /* number of cells referring to this entry at the last count */
+	uint8_t gen;
+} Link;
+
+static struct {
+	Link *a;
+	uint32_t len;
+	uint32_t siz;
+	uint32_t *bucket;
+	uint32_t nbucket;
+	uint32_t free;
+	uint32_t used;  /* entries in use */
+	uint32_t limit; /* entries in use at which the references are counted */
+} links = { .free = LINK_NONE, .limit = 256 };
+
+static uint32_t
+linkhash(const char *id, size_t idlen, const char *uri)
+{
+	uint32_t h = 2166136261u;
+
+	for (; idlen--; id++)
+		h = (h ^ (unsigned char)*id) * 16777619u;
+	h = (h ^ ';') * 16777619u;
+	for (; *uri; uri++)
+		h = (h ^ (unsigned char)*uri) * 16777619u;
+	return h;
+}
+
+static void
+linkrehash(uint32_t nbucket)
+{
+	uint32_t i, h;
+
+	links.nbucket = nbucket;
+	links.bucket = xrealloc(links.bucket, nbucket * sizeof(*links.bucket));
+	for (i = 0; i < nbucket; i++)
+		links.bucket[i] = LINK_NONE;
+	for (i = 0; i < links.len; i++) {
+		if (!links.a[i].uri)
+			continue;
+		h = links.a[i].hash & (nbucket - 1);
+		links.a[i].next = links.bucket[h];
+		links.bucket[h] = i;
+	}
+}
+
+/*
+ * Counts a reference to link, called for every cell by linkcount().
+ */
+void
+linkmark(uint32_t link)
+{
+	uint32_t i = LINKINDEX(link);
+
+	if (link && i < links.len && links.a[i].uri && links.a[i].gen == LINKGEN(link))
+		links.a[i].refs++;
+}
+
+static void
+linkmarklines(Line *line, int rows, int cols)
+{
+	int x, y;
+
+	for (y = 0; line && y < rows; y++) {
+		for (x = 0; x < cols; x++)
+			linkmark(line[y][x].link);
+	}
+}
+
+/*
+ * Counts the references to every link and frees the links that are no longer
+ * referred to.
+ */
+static void
+linkcount(void)
+{
+	uint32_t i;
+	#if REFLOW_PATCH && !COMPACT_GLYPH_PATCH
+	Line line;
+	int x, y;
+	#endif // REFLOW_PATCH
+
+	for (i = 0; i < links.len; i++)
+		links.a[i].refs = 0;
+
+	linkmark(term.c.attr.link);
+	linkmarklines(term.line, term.row, term.col);
+	#if REFLOW_PATCH
+	tsavedmarklinks();
+	#else
+	linkmarklines(term.alt, term.row, term.col);
+	#endif // REFLOW_PATCH
+	#if REFLOW_PATCH && COMPACT_GLYPH_PATCH
+	histmarklinks();
+	#elif REFLOW_PATCH
+	for (y = -HISTRING; y < 0; y++) {
+		line = TLINEABS(y);
+		for (x = 0; x < term.col; x++)
+			linkmark(line[x].link);
+	}
+	#elif SCROLLBACK_PATCH
+	linkmarklines(term.hist, HISTSIZE, term.col);
+	#endif // REFLOW_PATCH | SCROLLBACK_PATCH
+	#if REFLOW_PATCH && INCREMENTAL_REFLOW_PATCH
+	treflowmarklinks();
+	#endif // INCREMENTAL_REFLOW_PATCH
+
+	for (i = 0; i < links.len; i++) {
+		if (!links.a[i].uri || links.a[i].refs)
+			continue;
+		free(links.a[i].uri);
+		free(links.a[i].id);
+		links.a[i].uri = NULL;
+		links.a[i].gen++;
+		links.a[i].next = links.free;
+		links.free = i;
+		links.used--;
+	}
+	linkrehash(links.nbucket);
+	links.limit = MAX(links.used * 2, 256);
+}
+
+/*
+ * Returns the id of the link to uri, adding it to the table if it is new.
+ */
+static uint32_t
+linkintern(const char *id, size_t idlen, const char *uri)
+{
+	uint32_t i, h = linkhash(id, idlen, uri);
+
+	if (!links.nbucket)
+		linkrehash(256);
+
+	for (i = links.bucket[h & (links.nbucket - 1)]; i != LINK_NONE; i = links.a[i].next) {
+		if (links.a[i].hash == h && !strcmp(links.a[i].uri, uri) &&
+		    !strncmp(links.a[i].id, id, idlen) && !links.a[i].id[idlen])
+			goto found;
+	}
+
+	if (links.used >= links.limit)
+		linkcount();
+
+	if (links.free != LINK_NONE) {
+		i = links.free;
+		links.free = links.a[i].next;
+	} else {
+		if (links.len == LINKMAX - 1)
+			return 0;
+		if (links.len == links.siz) {
+			links.siz = MAX(links.siz * 2, 64);
+			links.a = xrealloc(links.a, links.siz * sizeof(*links.a));
+		}
+		i = links.len++;
+		links.a[i].gen = 0;
+		if (links.len > links.nbucket) {
+			links.a[i].uri = NULL;
+			linkrehash(links.nbucket * 2);
+		}
+	}
+	links.a[i].uri = xstrdup(uri);
+	links.a[i].id = xmalloc(idlen + 1);
+	memcpy(links.a[i].id, id, idlen);
+	links.a[i].id[idlen] = '\0';
+	links.a[i].hash = h;
+	links.a[i].next = links.bucket[h & (links.nbucket - 1)];
+	links.bucket[h & (links.nbucket - 1)] = i;
+	links.used++;
+
+found:
+	return (uint32_t)links.a[i].gen << 24 | (i + 1);
+}
+
+/*
+ * Returns the uri of link, or NULL if there is none.
+ */
+char *
+linkuri(uint32_t link)
+{
+	uint32_t i = LINKINDEX(link);
+
+	if (!link || i >= links.len || !links.a[i].uri || links.a[i].gen != LINKGEN(link))
+		return NULL;
+	return links.a[i].uri;
+}
+
+/*
+ * Handles OSC 8 ; params ; uri ST, which starts a link to uri, or ends the
+ * link if uri is empty. Cells with the same uri and id parameter are part of
+ * the same link.
+ */
+void
+osc8(const char *params, const char *uri)
+{
+	const char *id = "";
+	size_t idlen = 0;
+
+	if (!*uri) {
+		term.c.attr.link = 0;
+		return;
+	}
+
+	for (; *params; params += strcspn(params, ":"), params += !!*params) {
+		if (!strncmp(params, "id=", 3)) {
+			id = params + 3;
+			idlen = strcspn(id, ":");
+		}
+	}
+	term.c.attr.link = linkintern(id, idlen, uri);
+}
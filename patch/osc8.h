@@ -0,0 +1,3 @@
+void osc8(const char *params, const char *uri);
+char *linkuri(uint32_t link);
+void linkmark(uint32_t link);
@@ -59,6 +59,9 @@ tclearglyph(Glyph *gp, int usecurattr)
 	}
 	gp->mode = ATTR_NULL;
 	gp->u = ' ';
+	#if OSC8_PATCH
+	gp->link = 0;
+	#endif // OSC8_PATCH
 }
 
 #if SIXEL_PATCH
@@ -74,12 +77,31 @@ treflow_moveimages(int oldy, int newy)
 }
 #endif // SIXEL_PATCH
 
+#if SCROLLBACK_SPILL_PATCH
+/*
+ * Spills a reflowed line that does not fit into the history ring. term.histf
+ * is counted up along with term.histspill, so that the ring lines still to be
+ * reflowed keep their y coordinates.
+ */
+static void
+treflowspill(const Glyph *line, int col)
+{
+	#if INCREMENTAL_REFLOW_PATCH
+	/* the pending lines are older and go to the ring first */
+	if (treflowpending())
+		return;
+	#endif // INCREMENTAL_REFLOW_PATCH
+	if (spillappend(line, col))
+		term.histf++;
+}
+#endif // SCROLLBACK_SPILL_PATCH
+
 void
 treflow(int col, int row)
 {
 	int i, j;
 	int oce, nce, bot, scr;
-	int ox = 0, oy = -term.histf, nx = 0, ny = -1, len;
+	int ox = 0, oy = -HISTRING, nx = 0, ny = -1, len;
 	int cy = -1; /* proxy for new y coordinate of cursor */
 	int buflen, nlines;
 	Line *buf, bufline, line;
@@ -94,11 +116,24 @@ treflow(int col, int row)
 	for (oce = term.c.y; oce < term.row - 1 &&
 	                     tiswrapped(term.line[oce]); oce++);
 
+	#if INCREMENTAL_REFLOW_PATCH
+	/* the older history is reflowed later */
+	oy = treflowdefer(col, row, oce);
+	#endif // INCREMENTAL_REFLOW_PATCH
+
+	#if DYNAMIC_HISTORY_PATCH
+	nlines = histsize + row;
+	#else
 	nlines = HISTSIZE + row;
+	#endif // DYNAMIC_HISTORY_PATCH
 	buf = xmalloc(nlines * sizeof(Line));
 	do {
 		if (!nx && ++ny < nlines)
 			buf[ny] = xmalloc(col * sizeof(Glyph));
+		#if SCROLLBACK_SPILL_PATCH
+		else if (!nx)
+			treflowspill(buf[ny % nlines], col);
+		#endif // SCROLLBACK_SPILL_PATCH
 		if (!ox) {
 			line = TLINEABS(oy);
 			len = tlinelen(line);
@@ -193,18 +228,50 @@ treflow(int col, int row)
 		term.line[i] = buf[ny % nlines];
 	}
 	/* fill lines in history buffer and update term.histf */
-	for (/*i = -1 */; buflen > 0 && i >= -HISTSIZE; i--, ny--, buflen--) {
-		j = (term.histi + i + 1 + HISTSIZE) % HISTSIZE;
-		free(term.hist[j]);
-		term.hist[j] = buf[ny % nlines];
+	#if DYNAMIC_HISTORY_PATCH
+	while (term.histcap < MIN(buflen, (int)histsize) && histgrow(col))
+		;
+	#endif // DYNAMIC_HISTORY_PATCH
+	#if COMPACT_GLYPH_PATCH
+	histclear(col);
+	#endif // COMPACT_GLYPH_PATCH
+	for (/*i = -1 */; buflen > 0 && i >= -HISTMAX; i--, ny--, buflen--) {
+		j = (term.histi + i + 1 + HISTLINES) % HISTLINES;
+		#if COMPACT_GLYPH_PATCH
+		histstore(j, buf[ny % nlines], col);
+		free(buf[ny % nlines]);
+		#else
+		free(HIST(j));
+		HIST(j) = buf[ny % nlines];
+		#endif // COMPACT_GLYPH_PATCH
 	}
+	#if SCROLLBACK_SPILL_PATCH
+	/* spill the lines that did not fit into the ring, oldest first */
+	for (j = ny - buflen + 1; j <= ny; j++)
+		treflowspill(buf[j % nlines], col);
+	#endif // SCROLLBACK_SPILL_PATCH
 	term.histf = -i - 1;
+	#if SCROLLBACK_SPILL_PATCH
+	term.histf += term.histspill;
+	#endif // SCROLLBACK_SPILL_PATCH
+	#if KEYBOARDSELECT_PATCH && INDEXED_SEARCH_PATCH
+	term.histgen++;
+	#endif // INDEXED_SEARCH_PATCH
 	term.scr = MIN(term.scr, term.histf);
+	#if LAZY_ALLOC_PATCH && !COMPACT_GLYPH_PATCH
+	/* free the unused history lines, they are allocated again when needed */
+	for (/*i = -term.histf - 1 */; i >= -HISTLINES; i--) {
+		j = (term.histi + i + 1 + HISTLINES) % HISTLINES;
+		free(HIST(j));
+		HIST(j) = NULL;
+	}
+	#elif !COMPACT_GLYPH_PATCH
 	/* resize rest of the history lines */
-	for (/*i = -term.histf - 1 */; i >= -HISTSIZE; i--) {
-		j = (term.histi + i + 1 + HISTSIZE) % HISTSIZE;
-		term.hist[j] = xrealloc(term.hist[j], col * sizeof(Glyph));
+	for (/*i = -term.histf - 1 */; i >= -HISTLINES; i--) {
+		j = (term.histi + i + 1 + HISTLINES) % HISTLINES;
+		HIST(j) = xrealloc(HIST(j), col * sizeof(Glyph));
 	}
+	#endif // COMPACT_GLYPH_PATCH
 
 	#if SIXEL_PATCH
 	/* move images to the final position */
@@ -213,8 +280,8 @@ treflow(int col, int row)
 		if (im->reflow_y == INT_MIN) {
 			delete_image(im);
 		} else {
-			im->y = im->reflow_y - term.histf + term.scr - (ny + 1);
-			if (im->y - term.scr < -HISTSIZE || im->y - term.scr >= row)
+			im->y = im->reflow_y - HISTRING + term.scr - (ny + 1);
+			if (im->y - term.scr < -HISTMAX || im->y - term.scr >= row)
 				delete_image(im);
 		}
 	}
@@ -245,7 +312,7 @@ rscrolldown(int n)
 	if (IS_SET(MODE_ALTSCREEN))
 		return; */
 
-	if ((n = MIN(n, term.histf)) <= 0)
+	if ((n = MIN(n, HISTRING)) <= 0)
 		return;
 
 	for (i = term.c.y + n; i >= n; i--) {
@@ -254,10 +321,14 @@ rscrolldown(int n)
 		term.line[i-n] = temp;
 	}
 	for (/*i = n - 1 */; i >= 0; i--) {
+		#if COMPACT_GLYPH_PATCH
+		memcpy(term.line[i], histline(term.histi), term.col * sizeof(Glyph));
+		#else
 		temp = term.line[i];
-		term.line[i] = term.hist[term.histi];
-		term.hist[term.histi] = temp;
-		term.histi = (term.histi - 1 + HISTSIZE) % HISTSIZE;
+		term.line[i] = HIST(term.histi);
+		HIST(term.histi) = temp;
+		#endif // COMPACT_GLYPH_PATCH
+		term.histi = (term.histi - 1 + HISTLINES) % HISTLINES;
 	}
 	term.c.y += n;
 	term.histf -= n;
@@ -293,6 +364,10 @@ tresizedef(int col, int row)
 			tscrollup(0, term.row - 1, term.c.y - row + 1, SCROLL_RESIZE);
 			term.c.y = row - 1;
 		}
+		#if FAST_SCROLL_PATCH
+		/* the scroll moves the window, which has to be at the start to be reallocated */
+		tscrollringreset();
+		#endif // FAST_SCROLL_PATCH
 		for (i = row; i < term.row; i++)
 			free(term.line[i]);
 
@@ -304,6 +379,10 @@ tresizedef(int col, int row)
 			for (j = 0; j < col; j++)
 				tclearglyph(&term.line[i][j], 0);
 		}
+		#if INCREMENTAL_REFLOW_PATCH
+		/* bring enough of the pending history into the ring to fill the new rows */
+		treflowneed(row - term.row);
+		#endif // INCREMENTAL_REFLOW_PATCH
 		/* scroll down as much as height has increased */
 		rscrolldown(row - term.row);
 	}
@@ -406,7 +485,11 @@ kscrolldown(const Arg* a)
 
 	if (sel.ob.x != -1 && !sel.alt)
 		selmove(-n); /* negate change in term.scr */
+	#if SCROLL_BLIT_PATCH
+	tscrollview(n);
+	#else
 	tfulldirt();
+	#endif // SCROLL_BLIT_PATCH
 
 	#if SIXEL_PATCH
 	scroll_images(-1*n);
@@ -423,12 +506,17 @@ kscrollup(const Arg* a)
 {
 	int n = a->i;
 
-	if (!term.histf || IS_SET(MODE_ALTSCREEN))
-		return;
-
 	if (n < 0)
 		n = MAX(term.row / -n, 1);
 
+	#if INCREMENTAL_REFLOW_PATCH
+	if (!IS_SET(MODE_ALTSCREEN))
+		treflowneed(term.scr + n);
+	#endif // INCREMENTAL_REFLOW_PATCH
+
+	if (!term.histf || IS_SET(MODE_ALTSCREEN))
+		return;
+
 	if (term.scr + n <= term.histf) {
 		term.scr += n;
 	} else {
@@ -438,7 +526,11 @@ kscrollup(const Arg* a)
 
 	if (sel.ob.x != -1 && !sel.alt)
 		selmove(n); /* negate change in term.scr */
+	#if SCROLL_BLIT_PATCH
+	tscrollview(-n);
+	#else
 	tfulldirt();
+	#endif // SCROLL_BLIT_PATCH
 
 	#if SIXEL_PATCH
 	scroll_images(n);
@@ -456,12 +548,19 @@ tscrollup(int top, int bot, int n, int mode)
 	#if OPENURLONCLICK_PATCH
 	restoremousecursor();
 	#endif //OPENURLONCLICK_PATCH
+	#if BENCHMARK_PATCH
+	if (benchmode)
+		benchscrolls++;
+	#endif // BENCHMARK_PATCH
 
 	int i, j, s;
 	Line temp;
 	int alt = IS_SET(MODE_ALTSCREEN);
 	int savehist = !alt && top == 0 && mode != SCROLL_NOSAVEHIST;
 	int scr = alt ? 0 : term.scr;
+	#if SCROLLBACK_SPILL_PATCH || DYNAMIC_HISTORY_PATCH
+	int ring;
+	#endif // SCROLLBACK_SPILL_PATCH | DYNAMIC_HISTORY_PATCH
 	#if SIXEL_PATCH
 	int itop = top + scr, ibot = bot + scr;
 	ImageList *im, *next;
@@ -472,28 +571,93 @@ tscrollup(int top, int bot, int n, int mode)
 	n = MIN(n, bot-top+1);
 
 	if (savehist) {
+		#if INCREMENTAL_REFLOW_PATCH
+		treflowreserve(n);
+		#endif // INCREMENTAL_REFLOW_PATCH
+		#if SCROLLBACK_SPILL_PATCH || DYNAMIC_HISTORY_PATCH
+		ring = HISTRING;
+		#endif // SCROLLBACK_SPILL_PATCH | DYNAMIC_HISTORY_PATCH
 		for (i = 0; i < n; i++) {
-			term.histi = (term.histi + 1) % HISTSIZE;
-			temp = term.hist[term.histi];
+			#if DYNAMIC_HISTORY_PATCH
+			if (ring == term.histcap)
+				histgrowring(term.col);
+			#endif // DYNAMIC_HISTORY_PATCH
+			#if SCROLLBACK_SPILL_PATCH
+			/* spill the oldest line of a full history */
+			if (ring < HISTMAX)
+				ring++;
+			else
+				spillappend(HISTMAX ? HLINE((term.histi + 1 - HISTMAX + HISTLINES) % HISTLINES)
+				                    : term.line[i], term.col);
+			#elif DYNAMIC_HISTORY_PATCH
+			/* the history can grow halfway, so count the lines as they go */
+			if (ring < HISTMAX)
+				ring++;
+			#endif // SCROLLBACK_SPILL_PATCH
+			#if KEYBOARDSELECT_PATCH && INDEXED_SEARCH_PATCH
+			kbds_indexadd(term.line[i], term.histseq + i);
+			#endif // INDEXED_SEARCH_PATCH
+			term.histi = (term.histi + 1) % HISTLINES;
+			#if COMPACT_GLYPH_PATCH
+			histstore(term.histi, term.line[i], term.col);
+			for (j = 0; j < term.col; j++)
+				tclearglyph(&term.line[i][j], 1);
+			#else
+			temp = HIST(term.histi);
+			#if LAZY_ALLOC_PATCH
+			if (!temp)
+				temp = xmalloc(term.col * sizeof(Glyph));
+			#endif // LAZY_ALLOC_PATCH
 			for (j = 0; j < term.col; j++)
 				tclearglyph(&temp[j], 1);
-			term.hist[term.histi] = term.line[i];
+			HIST(term.histi) = term.line[i];
 			term.line[i] = temp;
+			#endif // COMPACT_GLYPH_PATCH
 		}
-		term.histf = MIN(term.histf + n, HISTSIZE);
+		#if KEYBOARDSELECT_PATCH && INDEXED_SEARCH_PATCH
+		term.histseq += n;
+		#endif // INDEXED_SEARCH_PATCH
+		#if SCROLLBACK_SPILL_PATCH
+		term.histf = ring + term.histspill;
+		#elif DYNAMIC_HISTORY_PATCH
+		term.histf = ring;
+		#else
+		term.histf = MIN(term.histf + n, HISTMAX);
+		#endif // SCROLLBACK_SPILL_PATCH
 		s = n;
 		if (term.scr) {
 			j = term.scr;
-			term.scr = MIN(j + n, HISTSIZE);
+			#if SCROLLBACK_SPILL_PATCH || DYNAMIC_HISTORY_PATCH
+			term.scr = MIN(j + n, term.histf);
+			#else
+			term.scr = MIN(j + n, HISTMAX);
+			#endif // SCROLLBACK_SPILL_PATCH | DYNAMIC_HISTORY_PATCH
 			s = j + n - term.scr;
 		}
+		#if SCROLL_BLIT_PATCH
+		if (mode != SCROLL_RESIZE && !term.scr) {
+			tsetdirt(0, n-1);
+			tscrollblit(0, bot, n);
+		} else if (mode != SCROLL_RESIZE)
+		#else
 		if (mode != SCROLL_RESIZE)
+		#endif // SCROLL_BLIT_PATCH
 			tfulldirt();
 	} else {
 		tclearregion(0, top, term.col-1, top+n-1, 1);
+		#if SCROLL_BLIT_PATCH
+		if (!scr)
+			tscrollblit(top, bot, n);
+		else
+		#endif // SCROLL_BLIT_PATCH
 		tsetdirt(top + scr, bot + scr);
 	}
 
+	#if FAST_SCROLL_PATCH
+	if (top == 0 && bot == term.row-1)
+		tscrollring(n);
+	else
+	#endif // FAST_SCROLL_PATCH
 	for (i = top; i <= bot-n; i++) {
 		temp = term.line[i];
 		term.line[i] = term.line[i+n];
@@ -523,7 +687,7 @@ tscrollup(int top, int bot, int n, int mode)
 				if (im->y < top)
 					im->y -= top; // move to scrollback
 			}
-			if (im->y < -HISTSIZE)
+			if (im->y < -HISTMAX)
 				delete_image(im);
 			else
 				im->y += term.scr;
@@ -548,6 +712,10 @@ tscrolldown(int top, int n)
 	#if OPENURLONCLICK_PATCH
 	restoremousecursor();
 	#endif //OPENURLONCLICK_PATCH
+	#if BENCHMARK_PATCH
+	if (benchmode)
+		benchscrolls++;
+	#endif // BENCHMARK_PATCH
 
 	int i, bot = term.bot;
 	int scr = IS_SET(MODE_ALTSCREEN) ? 0 : term.scr;
@@ -561,8 +729,16 @@ tscrolldown(int top, int n)
 		return;
 	n = MIN(n, bot-top+1);
 
+	#if SCROLL_BLIT_PATCH
+	tclearregion(0, bot-n+1, term.col-1, bot, 1);
+	if (!scr)
+		tscrollblit(top, bot, -n);
+	else
+		tsetdirt(top + scr, bot + scr);
+	#else
 	tsetdirt(top + scr, bot + scr);
 	tclearregion(0, bot-n+1, term.col-1, bot, 1);
+	#endif // SCROLL_BLIT_PATCH
 
 	for (i = bot; i >= top+n; i--) {
 		temp = term.line[i];
@@ -596,7 +772,14 @@ tresize(int col, int row)
 		win.mode ^= kbds_keyboardhandler(XK_Escape, NULL, 0, 1);
 	#endif // KEYBOARDSELECT_PATCH
 
+	#if FAST_SCROLL_PATCH
+	tscrollringreset();
+	#endif // FAST_SCROLL_PATCH
 	term.dirty = xrealloc(term.dirty, row * sizeof(*term.dirty));
+	#if DIRTY_SPAN_PATCH
+	term.dirtyminx = xrealloc(term.dirtyminx, row * sizeof(*term.dirtyminx));
+	term.dirtymaxx = xrealloc(term.dirtymaxx, row * sizeof(*term.dirtymaxx));
+	#endif // DIRTY_SPAN_PATCH
 	term.tabs = xrealloc(term.tabs, col * sizeof(*term.tabs));
 	if (col > term.col) {
 		bp = term.tabs + term.col;
@@ -623,7 +806,11 @@ tclearregion(int x1, int y1, int x2, int y2, int usecurattr)
 		selclear();
 
 	for (y = y1; y <= y2; y++) {
+		#if DIRTY_SPAN_PATCH
+		tsetdirtspan(y, x1, x2+1);
+		#else
 		term.dirty[y] = 1;
+		#endif // DIRTY_SPAN_PATCH
 		for (x = x1; x <= x2; x++)
 			tclearglyph(&term.line[y][x], usecurattr);
 	}
@@ -632,7 +819,17 @@ tclearregion(int x1, int y1, int x2, int y2, int usecurattr)
 void
 tnew(int col, int row)
 {
-	int i, j;
+	int j;
+	#if !LAZY_ALLOC_PATCH
+	int i;
+	#endif // LAZY_ALLOC_PATCH
+	#if LAZY_ALLOC_PATCH
+	/* the alternate screen is allocated by tresizealt() when first used */
+	term.line = xmalloc(row * sizeof(Line));
+	for (j = 0; j < row; j++)
+		term.line[j] = xmalloc(col * sizeof(Glyph));
+	term.col = col, term.row = row;
+	#else
 	for (i = 0; i < 2; i++) {
 		term.line = xmalloc(row * sizeof(Line));
 		for (j = 0; j < row; j++)
@@ -640,10 +837,22 @@ tnew(int col, int row)
 		term.col = col, term.row = row;
 		tswapscreen();
 	}
+	#endif // LAZY_ALLOC_PATCH
 	term.dirty = xmalloc(row * sizeof(*term.dirty));
+	#if DIRTY_SPAN_PATCH
+	term.dirtyminx = xmalloc(row * sizeof(*term.dirtyminx));
+	term.dirtymaxx = xmalloc(row * sizeof(*term.dirtymaxx));
+	#endif // DIRTY_SPAN_PATCH
 	term.tabs = xmalloc(col * sizeof(*term.tabs));
+	#if COMPACT_GLYPH_PATCH
+	histclear(col);
+	#elif !DYNAMIC_HISTORY_PATCH && !LAZY_ALLOC_PATCH
 	for (i = 0; i < HISTSIZE; i++)
-		term.hist[i] = xmalloc(col * sizeof(Glyph));
+		HIST(i) = xmalloc(col * sizeof(Glyph));
+	#endif // COMPACT_GLYPH_PATCH
+	#if DYNAMIC_HISTORY_PATCH
+	histgrow(col);
+	#endif // DYNAMIC_HISTORY_PATCH
 	treset();
 }
 
@@ -662,6 +871,9 @@ tdeletechar(int n)
 	                   https://stackoverflow.com/questions/29844298 */
 		line = term.line[term.c.y];
 		memmove(&line[dst], &line[src], size * sizeof(Glyph));
+		#if DIRTY_SPAN_PATCH
+		tsetdirtspan(term.c.y, dst, dst + size);
+		#endif // DIRTY_SPAN_PATCH
 	}
 	tclearregion(dst + size, term.c.y, term.col - 1, term.c.y, 1);
 }
@@ -681,6 +893,9 @@ tinsertblank(int n)
 	if (size > 0) { /* otherwise dst would point beyond the array */
 		line = term.line[term.c.y];
 		memmove(&line[dst], &line[src], size * sizeof(Glyph));
+		#if DIRTY_SPAN_PATCH
+		tsetdirtspan(term.c.y, dst, term.col);
+		#endif // DIRTY_SPAN_PATCH
 	}
 	tclearregion(src, term.c.y, dst - 1, term.c.y, 1);
 }
@@ -842,17 +1057,23 @@ selscroll(int top, int bot, int n)
 	}
 }
 
+/* the screen that is not shown, kept aside by tswapscreen() */
+static Line *altline;
+static int altcol, altrow;
+
 void
 tswapscreen(void)
 {
-	static Line *altline;
-	static int altcol, altrow;
-	Line *tmpline = term.line;
+	Line *tmpline;
 	int tmpcol = term.col, tmprow = term.row;
 	#if SIXEL_PATCH
 	ImageList *im = term.images;
 	#endif // SIXEL_PATCH
 
+	#if FAST_SCROLL_PATCH
+	tscrollringreset();
+	#endif // FAST_SCROLL_PATCH
+	tmpline = term.line;
 	term.line = altline;
 	term.col = altcol, term.row = altrow;
 	altline = tmpline;
@@ -865,6 +1086,22 @@ tswapscreen(void)
 	#endif // SIXEL_PATCH
 }
 
+#if OSC8_PATCH
+/*
+ * Marks the links on the screen that is not shown, see linkcount().
+ */
+void
+tsavedmarklinks(void)
+{
+	int x, y;
+
+	for (y = 0; altline && y < altrow; y++) {
+		for (x = 0; x < altcol; x++)
+			linkmark(altline[y][x].link);
+	}
+}
+#endif // OSC8_PATCH
+
 char *
 getsel(void)
 {
@@ -1,10 +1,36 @@
+#if DYNAMIC_HISTORY_PATCH
+#define HIST(i)   term.hist[(i) / HISTCHUNK][(i) % HISTCHUNK]
+#define HISTLINES term.histcap
+#define HISTMAX   MIN(term.histcap, (int)histsize)
+#else
+#define HIST(i)   term.hist[i]
+#define HISTLINES HISTSIZE
+#define HISTMAX   HISTSIZE
+#endif // DYNAMIC_HISTORY_PATCH
+
+#if COMPACT_GLYPH_PATCH
+#define HLINE(i) histline(i)
+#else
+#define HLINE(i) HIST(i)
+#endif // COMPACT_GLYPH_PATCH
+
+#if SCROLLBACK_SPILL_PATCH
+#define HISTRING  (term.histf - term.histspill)
+#define HISTLINE(y) ( \
+	(y) < -HISTRING ? spillline((y) + term.histf) \
+	                : HLINE((term.histi + (y) + 1 + HISTLINES) % HISTLINES) \
+)
+#else
+#define HISTRING  term.histf
+#define HISTLINE(y) HLINE((term.histi + (y) + 1 + HISTLINES) % HISTLINES)
+#endif // SCROLLBACK_SPILL_PATCH
+
 #define TLINE(y) ( \
-	(y) < term.scr ? term.hist[(term.histi + (y) - term.scr + 1 + HISTSIZE) % HISTSIZE] \
-	               : term.line[(y) - term.scr] \
+	(y) < term.scr ? HISTLINE((y) - term.scr) : term.line[(y) - term.scr] \
 )
 
 #define TLINEABS(y) ( \
-	(y) < 0 ? term.hist[(term.histi + (y) + 1 + HISTSIZE) % HISTSIZE] : term.line[(y)] \
+	(y) < 0 ? HISTLINE(y) : term.line[(y)] \
 )
 
 #define UPDATEWRAPNEXT(alt, col) do { \
@@ -33,6 +59,9 @@ static void tdeletechar(int);
 static int tlinelen(Line len);
 static char * tgetglyphs(char *buf, const Glyph *gp, const Glyph *lgp);
 static void selscroll(int, int, int);
+#if OSC8_PATCH
+void tsavedmarklinks(void);
+#endif // OSC8_PATCH
 
 typedef struct {
 	 uint b;
@@ -0,0 +1,967 @@
+/*
+ * The search string of keyboard select mode is matched literally until Tab is
+ * pressed while typing it, which toggles reading it as a regular expression.
+ * That is parsed once, compiled to a program of NFA instructions and run as a
+ * DFA that is built lazily, one state and transition at a time, as the history
+ * is searched. Runes are mapped to the classes of runes the pattern cannot tell
+ * apart, so that a transition is a single table lookup.
+ *
+ * A match does not go beyond a logical line, that is the lines joined by
+ * wrapping. Every logical line is first run through a DFA that only tells if
+ * a match ends anywhere in it. Only on the lines that have one are the
+ * leftmost-longest, non-overlapping matches found.
+ *
+ * Supported are . [] [^] * + ? {m} {m,} {m,n} | () ^ $, and the \d \w \s
+ * classes and their negations. Only \w goes beyond ASCII, it has the runes
+ * iswalnum() is true for. The search is case
+ * insensitive unless the pattern has an upper case character. If the pattern
+ * does not compile, the search string is matched literally.
+ */
+#define KRE_MAXINST    2048
+#define KRE_MAXCLASS   256
+#define KRE_MAXSTATES  1024
+#define KRE_HASHSIZ    (2 * KRE_MAXSTATES)
+#define KRE_MAXREPEAT  255
+#define KRE_RUNEMAX    0x10FFFF
+#define KRE_ALNUM      (KRE_RUNEMAX + 1)  /* non-ASCII runes iswalnum() is true for */
+#define KRE_OTHER      (KRE_RUNEMAX + 2)  /* and the other non-ASCII runes */
+
+enum {
+	KRE_SET,            /* consumes a rune in ranges x to x+y */
+	KRE_SPLIT,          /* goes on at both x and y */
+	KRE_JMP,            /* goes on at x */
+	KRE_BOL,            /* start of the logical line */
+	KRE_EOL,            /* end of the logical line */
+	KRE_MATCH,
+};
+
+enum {
+	KRA_SET,
+	KRA_CAT,
+	KRA_ALT,
+	KRA_REPEAT,         /* max < 0 means no limit */
+	KRA_BOL,
+	KRA_EOL,
+	KRA_EMPTY,
+};
+
+enum {
+	KRE_ACCEPT    = 1<<0,
+	KRE_ACCEPTEOL = 1<<1,
+};
+
+typedef struct {
+	Rune lo, hi;
+} KReRange;
+
+typedef struct {
+	int op;
+	int x, y;
+	int neg;
+} KReInst;
+
+typedef struct {
+	int type;
+	int a, b;
+	int min, max;
+	int neg;
+} KReNode;
+
+typedef struct {
+	int unanchored;     /* restarts the match at every rune */
+	int *next;          /* nstates * nclass transitions, -1 if not known yet */
+	int *off;           /* the instructions of state s are set[off[s]..off[s+1]] */
+	int *set;
+	int setsiz;
+	uchar *accept;
+	int nstates;
+	int start[2];       /* at the start of the line and after it */
+	int dead;           /* no match can go on from here */
+	int hash[KRE_HASHSIZ];
+	int flushes;
+} KDfa;
+
+static struct {
+	int ok;
+	int fold;
+	Rune *pat;
+	int npat, patsiz;
+	int i;              /* parse position */
+
+	KReRange *ranges;
+	int nranges, rangessiz;
+	KReNode *nodes;
+	int nnodes, nodessiz;
+	int root;
+	KReInst prog[KRE_MAXINST];
+	int ninst;
+
+	Rune bounds[KRE_MAXCLASS];
+	int nbase;          /* classes of runes, twice as many if \w is used */
+	int nclass;
+	int alnum;
+	uchar ascii[128];
+
+	uint mark[KRE_MAXINST];
+	uint gen;
+	int list[KRE_MAXINST];
+	int nlist;
+	KDfa find, match;
+
+	/* the logical line searched last */
+	int valid;
+	int top, bot;
+	int none;           /* it has no match */
+	Rune *r;
+	int *cell;
+	int nr, rsiz;
+	int *mlen;          /* length of the match starting at each cell */
+	int mlensiz;
+} kre;
+
+static const KReRange kre_digit[] = { { '0', '9' } };
+static const KReRange kre_nondigit[] = { { 0, '/' }, { ':', KRE_RUNEMAX } };
+static const KReRange kre_word[] = {
+	{ '0', '9' }, { 'A', 'Z' }, { '_', '_' }, { 'a', 'z' }, { KRE_ALNUM, KRE_ALNUM }
+};
+static const KReRange kre_nonword[] = {
+	{ 0, '/' }, { ':', '@' }, { '[', '^' }, { '`', '`' }, { '{', 0x7f }, { KRE_OTHER, KRE_OTHER }
+};
+static const KReRange kre_space[] = { { '\t', '\r' }, { ' ', ' ' } };
+static const KReRange kre_nonspace[] = { { 0, '\t' - 1 }, { '\r' + 1, ' ' - 1 }, { ' ' + 1, KRE_RUNEMAX } };
+
+static int kre_alt(void);
+
+static int
+kre_range(Rune lo, Rune hi)
+{
+	if (kre.nranges == kre.rangessiz) {
+		kre.rangessiz = MAX(kre.rangessiz * 2, 64);
+		kre.ranges = xrealloc(kre.ranges, kre.rangessiz * sizeof(*kre.ranges));
+	}
+	kre.ranges[kre.nranges].lo = lo;
+	kre.ranges[kre.nranges].hi = hi;
+	return kre.nranges++;
+}
+
+static int
+kre_node(int type, int a, int b)
+{
+	if (kre.nnodes == kre.nodessiz) {
+		kre.nodessiz = MAX(kre.nodessiz * 2, 64);
+		kre.nodes = xrealloc(kre.nodes, kre.nodessiz * sizeof(*kre.nodes));
+	}
+	kre.nodes[kre.nnodes] = (KReNode){ .type = type, .a = a, .b = b };
+	return kre.nnodes++;
+}
+
+static int
+kre_setnode(int first, int neg)
+{
+	int n = kre_node(KRA_SET, first, kre.nranges - first);
+
+	kre.nodes[n].neg = neg;
+	return n;
+}
+
+/*
+ * Adds the ranges of class \d, \w, \s, \D, \W or \S.
+ */
+static int
+kre_addclass(Rune c)
+{
+	const KReRange *cls;
+	int i, n;
+
+	switch (c) {
+	case 'd': cls = kre_digit; n = LEN(kre_digit); break;
+	case 'D': cls = kre_nondigit; n = LEN(kre_nondigit); break;
+	case 'w': cls = kre_word; n = LEN(kre_word); break;
+	case 'W': cls = kre_nonword; n = LEN(kre_nonword); break;
+	case 's': cls = kre_space; n = LEN(kre_space); break;
+	case 'S': cls = kre_nonspace; n = LEN(kre_nonspace); break;
+	default: return 0;
+	}
+	for (i = 0; i < n; i++)
+		kre_range(cls[i].lo, cls[i].hi);
+	return 1;
+}
+
+static Rune
+kre_escape(Rune c)
+{
+	return c == 't' ? '\t' : c;
+}
+
+static int
+kre_bracket(void)
+{
+	int first = kre.nranges, neg = 0;
+	Rune lo, hi;
+
+	if (kre.i < kre.npat && kre.pat[kre.i] == '^') {
+		neg = 1;
+		kre.i++;
+	}
+	/* a ] right after the [ or [^ is a literal */
+	do {
+		if (kre.i >= kre.npat)
+			return -1;
+		lo = kre.pat[kre.i++];
+		if (lo == '\\') {
+			if (kre.i >= kre.npat)
+				return -1;
+			if (kre_addclass(kre.pat[kre.i])) {
+				kre.i++;
+				continue;
+			}
+			lo = kre_escape(kre.pat[kre.i++]);
+		}
+		hi = lo;
+		if (kre.i + 1 < kre.npat && kre.pat[kre.i] == '-' && kre.pat[kre.i + 1] != ']') {
+			hi = kre.pat[kre.i + 1];
+			kre.i += 2;
+			if (hi == '\\') {
+				if (kre.i >= kre.npat)
+					return -1;
+				hi = kre_escape(kre.pat[kre.i++]);
+			}
+			if (hi < lo)
+				return -1;
+		}
+		kre_range(lo, hi);
+	} while (kre.i < kre.npat && kre.pat[kre.i] != ']');
+
+	if (kre.i++ >= kre.npat)
+		return -1;
+	return kre_setnode(first, neg);
+}
+
+static int
+kre_atom(void)
+{
+	int n, first = kre.nranges;
+	Rune u;
+
+	if (kre.i >= kre.npat)
+		return -1;
+
+	switch ((u = kre.pat[kre.i++])) {
+	case '(':
+		if ((n = kre_alt()) < 0 || kre.i >= kre.npat || kre.pat[kre.i] != ')')
+			return -1;
+		kre.i++;
+		return n;
+	case '[':
+		return kre_bracket();
+	case '.':
+		kre_range(0, KRE_RUNEMAX);
+		return kre_setnode(first, 0);
+	case '^':
+		return kre_node(KRA_BOL, -1, -1);
+	case '$':
+		return kre_node(KRA_EOL, -1, -1);
+	case '*':
+	case '+':
+	case '?':
+		return -1;
+	case '\\':
+		if (kre.i >= kre.npat)
+			return -1;
+		u = kre.pat[kre.i++];
+		if (kre_addclass(u))
+			return kre_setnode(first, 0);
+		u = kre_escape(u);
+		/* FALLTHROUGH */
+	default:
+		kre_range(u, u);
+		return kre_setnode(first, 0);
+	}
+}
+
+static int
+kre_number(int *n)
+{
+	int start = kre.i;
+
+	for (*n = 0; kre.i < kre.npat && BETWEEN(kre.pat[kre.i], '0', '9'); kre.i++) {
+		if ((*n = *n * 10 + kre.pat[kre.i] - '0') > KRE_MAXREPEAT)
+			return 0;
+	}
+	return kre.i > start;
+}
+
+/*
+ * Parses {m}, {m,} or {m,n}. Anything else is left to be read as literals.
+ */
+static int
+kre_bounds(int *min, int *max)
+{
+	int start = kre.i;
+
+	if (kre.pat[kre.i++] != '{' || !kre_number(min))
+		goto literal;
+	*max = *min;
+	if (kre.i < kre.npat && kre.pat[kre.i] == ',') {
+		kre.i++;
+		if (!kre_number(max))
+			*max = -1;
+		else if (*max < *min)
+			goto literal;
+	}
+	if (kre.i < kre.npat && kre.pat[kre.i] == '}') {
+		kre.i++;
+		return 1;
+	}
+literal:
+	kre.i = start;
+	return 0;
+}
+
+static int
+kre_repeat(void)
+{
+	int n, min, max;
+	Rune u;
+
+	if ((n = kre_atom()) < 0)
+		return -1;
+	while (kre.i < kre.npat) {
+		u = kre.pat[kre.i];
+		if (u == '*' || u == '+' || u == '?') {
+			min = (u == '+');
+			max = (u == '?') ? 1 : -1;
+			kre.i++;
+		} else if (u != '{' || !kre_bounds(&min, &max)) {
+			break;
+		}
+		n = kre_node(KRA_REPEAT, n, -1);
+		kre.nodes[n].min = min;
+		kre.nodes[n].max = max;
+	}
+	return n;
+}
+
+static int
+kre_cat(void)
+{
+	int n = -1, m;
+
+	while (kre.i < kre.npat && kre.pat[kre.i] != '|' && kre.pat[kre.i] != ')') {
+		if ((m = kre_repeat()) < 0)
+			return -1;
+		n = (n < 0) ? m : kre_node(KRA_CAT, n, m);
+	}
+	return (n < 0) ? kre_node(KRA_EMPTY, -1, -1) : n;
+}
+
+static int
+kre_alt(void)
+{
+	int n, m;
+
+	if ((n = kre_cat()) < 0)
+		return -1;
+	while (kre.i < kre.npat && kre.pat[kre.i] == '|') {
+		kre.i++;
+		if ((m = kre_cat()) < 0)
+			return -1;
+		n = kre_node(KRA_ALT, n, m);
+	}
+	return n;
+}
+
+static int
+kre_emit(int op, int x, int y)
+{
+	if (kre.ninst >= KRE_MAXINST)
+		return -1;
+	kre.prog[kre.ninst] = (KReInst){ .op = op, .x = x, .y = y };
+	return kre.ninst++;
+}
+
+/*
+ * Appends the instructions of node n to the program.
+ *
+ * Returns 0 if the program is too large.
+ */
+static int
+kre_gen(int n)
+{
+	KReNode *nd = &kre.nodes[n];
+	int pc, i, pending = -1;
+
+	switch (nd->type) {
+	case KRA_SET:
+		if ((pc = kre_emit(KRE_SET, nd->a, nd->b)) < 0)
+			return 0;
+		kre.prog[pc].neg = nd->neg;
+		return 1;
+	case KRA_CAT:
+		return kre_gen(nd->a) && kre_gen(nd->b);
+	case KRA_ALT:
+		if ((pc = kre_emit(KRE_SPLIT, 0, 0)) < 0 || !kre_gen(nd->a))
+			return 0;
+		if ((i = kre_emit(KRE_JMP, 0, 0)) < 0)
+			return 0;
+		kre.prog[pc].x = pc + 1;
+		kre.prog[pc].y = kre.ninst;
+		if (!kre_gen(nd->b))
+			return 0;
+		kre.prog[i].x = kre.ninst;
+		return 1;
+	case KRA_REPEAT:
+		for (i = 0; i < nd->min; i++) {
+			if (!kre_gen(nd->a))
+				return 0;
+		}
+		if (nd->max < 0) {
+			if ((pc = kre_emit(KRE_SPLIT, 0, 0)) < 0 || !kre_gen(nd->a))
+				return 0;
+			if (kre_emit(KRE_JMP, pc, 0) < 0)
+				return 0;
+			kre.prog[pc].x = pc + 1;
+			kre.prog[pc].y = kre.ninst;
+			return 1;
+		}
+		/* every optional copy can skip to the end, they are chained through y
+		 * until the end is known */
+		for (i = nd->min; i < nd->max; i++) {
+			if ((pc = kre_emit(KRE_SPLIT, 0, pending)) < 0 || !kre_gen(nd->a))
+				return 0;
+			kre.prog[pc].x = pc + 1;
+			pending = pc;
+		}
+		for (; pending >= 0; pending = i) {
+			i = kre.prog[pending].y;
+			kre.prog[pending].y = kre.ninst;
+		}
+		return 1;
+	case KRA_BOL:
+		return kre_emit(KRE_BOL, 0, 0) >= 0;
+	case KRA_EOL:
+		return kre_emit(KRE_EOL, 0, 0) >= 0;
+	}
+	return 1;
+}
+
+/*
+ * Collects up to max characters that every match of node n has, without
+ * repeating them.
+ */
+static int
+kre_must(int n, Rune *u, int max)
+{
+	KReNode *nd = &kre.nodes[n];
+	Rune v[32];
+	int i, j, k, l, nv;
+
+	switch (nd->type) {
+	case KRA_SET:
+		if (nd->neg || nd->b != 1 || kre.ranges[nd->a].lo != kre.ranges[nd->a].hi || max < 1)
+			return 0;
+		u[0] = kre.ranges[nd->a].lo;
+		return 1;
+	case KRA_CAT:
+		k = kre_must(nd->a, u, max);
+		nv = kre_must(nd->b, v, MIN(max, LEN(v)));
+		for (i = 0; i < nv && k < max; i++) {
+			for (j = 0; j < k && u[j] != v[i]; j++)
+				;
+			if (j == k)
+				u[k++] = v[i];
+		}
+		return k;
+	case KRA_ALT:
+		k = kre_must(nd->a, u, max);
+		nv = kre_must(nd->b, v, MIN(max, LEN(v)));
+		for (i = j = 0; i < k; i++) {
+			for (l = 0; l < nv && v[l] != u[i]; l++)
+				;
+			if (l < nv)
+				u[j++] = u[i];
+		}
+		return j;
+	case KRA_REPEAT:
+		return nd->min > 0 ? kre_must(nd->a, u, max) : 0;
+	}
+	return 0;
+}
+
+static int
+kre_runecmp(const void *a, const void *b)
+{
+	Rune x = *(const Rune *)a, y = *(const Rune *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Splits the runes into the classes of runes that every set of the program
+ * either has all or none of.
+ *
+ * Returns 0 if there are too many classes.
+ */
+static int
+kre_classes(void)
+{
+	Rune *b = xmalloc((2 * kre.nranges + 1) * sizeof(Rune));
+	int i, n = 0, nb = 0, c;
+
+	kre.alnum = 0;
+	for (i = 0; i < kre.nranges; i++) {
+		if (kre.ranges[i].lo > KRE_RUNEMAX) {
+			/* the classes beyond ASCII are split by iswalnum() */
+			kre.alnum = 1;
+			b[n++] = 128;
+			continue;
+		}
+		b[n++] = kre.ranges[i].lo;
+		if (kre.ranges[i].hi < KRE_RUNEMAX)
+			b[n++] = kre.ranges[i].hi + 1;
+	}
+	qsort(b, n, sizeof(Rune), kre_runecmp);
+	for (i = 0; i < n; i++) {
+		if (b[i] > 0 && (nb == 0 || b[i] != kre.bounds[nb - 1])) {
+			if (nb == KRE_MAXCLASS - 1) {
+				free(b);
+				return 0;
+			}
+			kre.bounds[nb++] = b[i];
+		}
+	}
+	free(b);
+	kre.nbase = nb + 1;
+	kre.nclass = kre.alnum ? 2 * kre.nbase : kre.nbase;
+
+	/* class k holds the runes from bounds[k-1] up to bounds[k] */
+	for (i = c = 0; i < 128; i++) {
+		for (; c < nb && kre.bounds[c] <= i; c++)
+			;
+		kre.ascii[i] = c;
+	}
+	if (kre.fold) {
+		for (i = 'A'; i <= 'Z'; i++)
+			kre.ascii[i] = kre.ascii[i - 'A' + 'a'];
+	}
+	return 1;
+}
+
+static int
+kre_class(Rune u)
+{
+	int lo = 0, hi = kre.nbase - 1, mid;
+
+	if (u < 128)
+		return kre.ascii[u];
+	if (kre.fold)
+		u = towlower(u);
+	/* the number of bounds not above u */
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (kre.bounds[mid] <= u)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return (kre.alnum && iswalnum(u)) ? lo + kre.nbase : lo;
+}
+
+static int
+kre_inset(KReInst *in, int c)
+{
+	Rune u = (c % kre.nbase) > 0 ? kre.bounds[c % kre.nbase - 1] : 0;
+	int i, alnum = c >= kre.nbase, hit;
+
+	for (i = in->x; i < in->x + in->y; i++) {
+		switch (kre.ranges[i].lo) {
+		case KRE_ALNUM: hit = u >= 128 && alnum; break;
+		case KRE_OTHER: hit = u >= 128 && !alnum; break;
+		default: hit = BETWEEN(u, kre.ranges[i].lo, kre.ranges[i].hi); break;
+		}
+		if (hit)
+			return !in->neg;
+	}
+	return in->neg;
+}
+
+/*
+ * Adds the instructions reachable from pc without consuming a rune to the
+ * list.
+ */
+static void
+kre_add(int pc, int bol, int eol)
+{
+	KReInst *in;
+
+	for (;;) {
+		if (kre.mark[pc] == kre.gen)
+			return;
+		kre.mark[pc] = kre.gen;
+		in = &kre.prog[pc];
+		switch (in->op) {
+		case KRE_SPLIT:
+			kre_add(in->x, bol, eol);
+			pc = in->y;
+			break;
+		case KRE_JMP:
+			pc = in->x;
+			break;
+		case KRE_BOL:
+			if (!bol)
+				return;
+			pc++;
+			break;
+		case KRE_EOL:
+			if (eol) {
+				pc++;
+				break;
+			}
+			/* FALLTHROUGH */
+		default:
+			kre.list[kre.nlist++] = pc;
+			return;
+		}
+	}
+}
+
+static int
+kre_intcmp(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
+static void kre_flush(KDfa *d);
+
+/*
+ * Returns the state of the DFA for the instructions in the list.
+ */
+static int
+kre_state(KDfa *d)
+{
+	uint h = 2166136261u;
+	int i, s, slot, n = kre.nlist, *set;
+	uchar accept = 0;
+
+	qsort(kre.list, n, sizeof(int), kre_intcmp);
+	for (i = 0; i < n; i++)
+		h = (h ^ kre.list[i]) * 16777619u;
+
+	for (slot = h & (KRE_HASHSIZ - 1); (s = d->hash[slot] - 1) >= 0;
+	     slot = (slot + 1) & (KRE_HASHSIZ - 1)) {
+		if (d->off[s + 1] - d->off[s] == n &&
+		    !memcmp(d->set + d->off[s], kre.list, n * sizeof(int)))
+			return s;
+	}
+
+	if (d->nstates == KRE_MAXSTATES) {
+		kre_flush(d);
+		return kre_state(d);
+	}
+
+	s = d->nstates++;
+	if (d->off[s] + n > d->setsiz) {
+		d->setsiz = MAX(d->setsiz * 2, d->off[s] + n);
+		d->set = xrealloc(d->set, d->setsiz * sizeof(int));
+	}
+	memcpy(d->set + d->off[s], kre.list, n * sizeof(int));
+	d->off[s + 1] = d->off[s] + n;
+	d->hash[slot] = s + 1;
+	for (i = 0; i < kre.nclass; i++)
+		d->next[s * kre.nclass + i] = -1;
+
+	/* the instructions that only wait for the end of the line */
+	set = d->set + d->off[s];
+	kre.gen++;
+	kre.nlist = 0;
+	for (i = 0; i < n; i++) {
+		if (kre.prog[set[i]].op == KRE_MATCH)
+			accept |= KRE_ACCEPT;
+		else if (kre.prog[set[i]].op == KRE_EOL)
+			kre_add(set[i] + 1, 0, 1);
+	}
+	for (i = 0; i < kre.nlist; i++) {
+		if (kre.prog[kre.list[i]].op == KRE_MATCH)
+			accept |= KRE_ACCEPTEOL;
+	}
+	d->accept[s] = accept | ((accept & KRE_ACCEPT) ? KRE_ACCEPTEOL : 0);
+	return s;
+}
+
+static int
+kre_start(KDfa *d, int bol)
+{
+	kre.gen++;
+	kre.nlist = 0;
+	kre_add(0, bol, 0);
+	return kre_state(d);
+}
+
+/*
+ * Drops all states, to make room for new ones.
+ */
+static void
+kre_flush(KDfa *d)
+{
+	int list[KRE_MAXINST], n = kre.nlist;
+
+	memcpy(list, kre.list, n * sizeof(int));
+	memset(d->hash, 0, sizeof(d->hash));
+	d->nstates = 0;
+	d->flushes++;
+	d->start[0] = kre_start(d, 1);
+	d->start[1] = kre_start(d, 0);
+	kre.nlist = 0;
+	d->dead = kre_state(d);
+	memcpy(kre.list, list, n * sizeof(int));
+	kre.nlist = n;
+}
+
+static int
+kre_next(KDfa *d, int s, int c)
+{
+	int *t = &d->next[s * kre.nclass + c], flushes = d->flushes;
+	int i, *set = d->set + d->off[s], n = d->off[s + 1] - d->off[s];
+	int next;
+
+	if (*t >= 0)
+		return *t;
+
+	kre.gen++;
+	kre.nlist = 0;
+	for (i = 0; i < n; i++) {
+		if (kre.prog[set[i]].op == KRE_SET && kre_inset(&kre.prog[set[i]], c))
+			kre_add(set[i] + 1, 0, 0);
+	}
+	if (d->unanchored)
+		kre_add(0, 0, 0);
+	next = kre_state(d);
+	if (d->flushes == flushes)
+		*t = next;
+	return next;
+}
+
+static void
+kre_dfainit(KDfa *d, int unanchored)
+{
+	free(d->next);
+	free(d->off);
+	free(d->accept);
+	d->unanchored = unanchored;
+	d->next = xmalloc(KRE_MAXSTATES * kre.nclass * sizeof(int));
+	d->off = xmalloc((KRE_MAXSTATES + 1) * sizeof(int));
+	d->accept = xmalloc(KRE_MAXSTATES);
+	d->off[0] = 0;
+	d->flushes = 0;
+	kre.nlist = 0;
+	kre_flush(d);
+}
+
+/*
+ * Returns 1 if a match ends anywhere in the runes.
+ */
+static int
+kre_find(const Rune *r, int n)
+{
+	KDfa *d = &kre.find;
+	int i, c, t, s = d->start[0];
+
+	for (i = 0; i < n; i++) {
+		if (d->accept[s] & KRE_ACCEPT)
+			return 1;
+		c = r[i] < 128 ? kre.ascii[r[i]] : kre_class(r[i]);
+		s = (t = d->next[s * kre.nclass + c]) >= 0 ? t : kre_next(d, s, c);
+	}
+	return d->accept[s] != 0;
+}
+
+/*
+ * Returns the end of the longest match that starts at rune i, or -1.
+ */
+static int
+kre_longest(const Rune *r, int n, int i)
+{
+	KDfa *d = &kre.match;
+	int s = d->start[i > 0], end = -1, c, t;
+
+	for (;; i++) {
+		if (d->accept[s] & KRE_ACCEPT)
+			end = i;
+		if (i == n) {
+			if (d->accept[s] & KRE_ACCEPTEOL)
+				end = n;
+			break;
+		}
+		c = r[i] < 128 ? kre.ascii[r[i]] : kre_class(r[i]);
+		s = (t = d->next[s * kre.nclass + c]) >= 0 ? t : kre_next(d, s, c);
+		if (s == d->dead)
+			break;
+	}
+	return end;
+}
+
+/*
+ * Compiles the search string if it changed, and forgets the matches found so
+ * far.
+ */
+void
+kbds_recompile(void)
+{
+	int i, n, esc, fold;
+	Rune u;
+
+	kre.valid = 0;
+
+	if (!kbds_regex) {
+		kre.ok = kre.npat = 0;
+		return;
+	}
+
+	for (i = n = 0; i < kbds_searchlen; i++)
+		n += !(kbds_searchstr[i].mode & ATTR_WDUMMY);
+	if (n == kre.npat) {
+		for (i = n = 0; i < kbds_searchlen; i++) {
+			if (!(kbds_searchstr[i].mode & ATTR_WDUMMY) &&
+			    kbds_searchstr[i].u != kre.pat[n++])
+				break;
+		}
+		if (i == kbds_searchlen && kre.npat > 0)
+			return;
+	}
+
+	if (n > kre.patsiz) {
+		kre.patsiz = n;
+		kre.pat = xrealloc(kre.pat, n * sizeof(Rune));
+	}
+	for (i = n = 0, esc = 0, fold = 1; i < kbds_searchlen; i++) {
+		if (kbds_searchstr[i].mode & ATTR_WDUMMY)
+			continue;
+		kre.pat[n++] = kbds_searchstr[i].u;
+		/* \D, \W and \S are not upper case characters */
+		u = kbds_searchstr[i].u;
+		if (!(esc && (u == 'D' || u == 'W' || u == 'S')) && u != towlower(u))
+			fold = 0;
+		esc = !esc && u == '\\';
+	}
+	kre.npat = n;
+	kre.fold = fold;
+
+	kre.i = kre.nranges = kre.nnodes = kre.ninst = 0;
+	kre.ok = n > 0 && (kre.root = kre_alt()) >= 0 && kre.i == kre.npat &&
+		kre_gen(kre.root) && kre_emit(KRE_MATCH, 0, 0) >= 0 && kre_classes();
+	if (kre.ok) {
+		memset(kre.mark, 0, sizeof(kre.mark));
+		kre.gen = 0;
+		kre_dfainit(&kre.find, 1);
+		kre_dfainit(&kre.match, 0);
+	}
+}
+
+/*
+ * Returns 1 if the search string is used as a regular expression.
+ */
+int
+kbds_isregex(void)
+{
+	return kre.ok;
+}
+
+/*
+ * Collects up to max characters that every match has.
+ */
+int
+kbds_rerequired(Rune *u, int max)
+{
+	return kre.ok ? kre_must(kre.root, u, max) : 0;
+}
+
+static int
+kre_iswrapped(int y)
+{
+	Line line = TLINE(y);
+	int len = tlinelen(line);
+
+	return len > 0 && (line[len - 1].mode & ATTR_WRAP);
+}
+
+/*
+ * Finds the matches in the logical line that line y is part of.
+ */
+static void
+kre_loadline(int y)
+{
+	Line line;
+	int x, len, s, e, ncells;
+
+	/* searching down, the logical line above ended right before line y */
+	if (kre.valid && y == kre.bot + 1)
+		kre.top = y;
+	else
+		for (kre.top = y; kre.top > kbds_top() && kre_iswrapped(kre.top - 1); kre.top--)
+			;
+	kre.nr = 0;
+	for (kre.bot = kre.top;; kre.bot++) {
+		line = TLINE(kre.bot);
+		len = tlinelen(line);
+		if (kre.nr + len > kre.rsiz) {
+			kre.rsiz = MAX(kre.rsiz * 2, kre.nr + len);
+			kre.r = xrealloc(kre.r, kre.rsiz * sizeof(Rune));
+			kre.cell = xrealloc(kre.cell, kre.rsiz * sizeof(int));
+		}
+		/* the cells kbds_moveforward() goes over */
+		for (x = 0; x < len; x++) {
+			kre.r[kre.nr] = line[x].u;
+			kre.cell[kre.nr++] = (kre.bot - kre.top) * term.col + x;
+			if (x + 1 < len && (line[x + 1].mode & ATTR_WDUMMY))
+				x++;
+		}
+		if (kre.bot >= kbds_bot() || len == 0 || !(line[len - 1].mode & ATTR_WRAP))
+			break;
+	}
+	kre.valid = 1;
+
+	if ((kre.none = !kre_find(kre.r, kre.nr)))
+		return;
+
+	ncells = (kre.bot - kre.top + 1) * term.col;
+	if (ncells > kre.mlensiz) {
+		kre.mlensiz = MAX(kre.mlensiz * 2, ncells);
+		kre.mlen = xrealloc(kre.mlen, kre.mlensiz * sizeof(int));
+	}
+	memset(kre.mlen, 0, ncells * sizeof(int));
+	/* an empty match is not one */
+	for (s = 0, kre.none = 1; s < kre.nr;) {
+		if ((e = kre_longest(kre.r, kre.nr, s)) > s) {
+			kre.mlen[kre.cell[s]] = e - s;
+			kre.none = 0;
+			s = e;
+		} else {
+			s++;
+		}
+	}
+}
+
+/*
+ * Returns 1 if a match starts on the logical line that line y is part of.
+ */
+int
+kbds_rehasmatch(int y)
+{
+	if (!kre.valid || y < kre.top || y > kre.bot)
+		kre_loadline(y);
+	return !kre.none;
+}
+
+/*
+ * Returns the number of characters in the match that starts at cell x of line
+ * y, or 0 if none does.
+ */
+int
+kbds_rematch(int x, int y)
+{
+	if (!kre.valid || y < kre.top || y > kre.bot)
+		kre_loadline(y);
+	if (kre.none || x >= term.col)
+		return 0;
+	return kre.mlen[(y - kre.top) * term.col + x];
+}
@@ -0,0 +1,5 @@
+void kbds_recompile(void);
+int kbds_isregex(void);
+int kbds_rehasmatch(int y);
+int kbds_rematch(int x, int y);
+int kbds_rerequired(Rune *u, int max);
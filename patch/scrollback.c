@@ -12,7 +12,11 @@ kscrolldown(const Arg* a)
 	if (term.scr > 0) {
 		term.scr -= n;
 		selscroll(0, -n);
+		#if SCROLL_BLIT_PATCH
+		tscrollview(n);
+		#else
 		tfulldirt();
+		#endif // SCROLL_BLIT_PATCH
 	}
 
 	#if SIXEL_PATCH
@@ -41,7 +45,11 @@ kscrollup(const Arg* a)
 	if (term.scr <= HISTSIZE-n) {
 		term.scr += n;
 		selscroll(0, n);
+		#if SCROLL_BLIT_PATCH
+		tscrollview(-n);
+		#else
 		tfulldirt();
+		#endif // SCROLL_BLIT_PATCH
 	}
 
 	#if SIXEL_PATCH
@@ -0,0 +1,111 @@
+/*
+ * When lines scroll the dirty flags are rotated along with them and the scroll
+ * is recorded in term.scrolln, rather than marking every line that moved as
+ * dirty. draw() then has what is already on screen moved by xscroll() and only
+ * redraws the lines that were scrolled in, or that were dirty to begin with.
+ *
+ * Only one scrolling region can be pending at a time. A scroll of any other
+ * region, or one while there is a selection or an image on screen, marks the
+ * lines dirty as before.
+ */
+
+/* output arrived while scrolled back, which term.dirty does not reflect */
+int scrollstale = 0;
+
+static void
+tdirtrotate(int *a, int len, int n)
+{
+	int i, j, t;
+
+	/* rotate a[0..len) left by n as three reversals */
+	for (i = 0, j = n - 1; i < j; i++, j--)
+		t = a[i], a[i] = a[j], a[j] = t;
+	for (i = n, j = len - 1; i < j; i++, j--)
+		t = a[i], a[i] = a[j], a[j] = t;
+	for (i = 0, j = len - 1; i < j; i++, j--)
+		t = a[i], a[i] = a[j], a[j] = t;
+}
+
+/*
+ * Records that the lines top to bot have moved up by n lines, or down if n is
+ * negative. The lines scrolled in must already be marked dirty, as
+ * tclearregion() does, at the position they had before the scroll.
+ */
+void
+tscrollblit(int top, int bot, int n)
+{
+	int len = bot - top + 1, r;
+
+	if (sel.ob.x != -1
+	    #if SIXEL_PATCH
+	    || term.images
+	    #endif // SIXEL_PATCH
+	    || (term.scrolln && (term.scrolltop != top || term.scrollbot != bot))) {
+		tsetdirt(top, bot);
+		return;
+	}
+
+	r = ((n % len) + len) % len;
+	if (r) {
+		tdirtrotate(term.dirty + top, len, r);
+		#if DIRTY_SPAN_PATCH
+		tdirtrotate(term.dirtyminx + top, len, r);
+		tdirtrotate(term.dirtymaxx + top, len, r);
+		#endif // DIRTY_SPAN_PATCH
+		#if REFLOW_PATCH && URL_CACHE_PATCH
+		urlcachescroll(top, bot, n);
+		#endif // URL_CACHE_PATCH
+	}
+	term.scrolltop = top;
+	term.scrollbot = bot;
+	term.scrolln += n;
+}
+
+#if SCROLLBACK_PATCH || REFLOW_PATCH
+/*
+ * Same as tfulldirt() for when the scrollback view has moved by n lines, up
+ * when n is positive.
+ */
+void
+tscrollview(int n)
+{
+	if (!n)
+		return;
+	if (abs(n) >= term.row || scrollstale) {
+		tfulldirt();
+		return;
+	}
+
+	#if SYNC_PATCH
+	tsync_end();
+	#endif // SYNC_PATCH
+	if (n > 0)
+		tsetdirt(0, n - 1);
+	else
+		tsetdirt(term.row + n, term.row - 1);
+	tscrollblit(0, term.row - 1, n);
+}
+#endif // SCROLLBACK_PATCH | REFLOW_PATCH
+
+/*
+ * Moves what is on screen for the pending scroll, called by draw() before any
+ * lines are drawn.
+ */
+void
+tscrollblitdraw(void)
+{
+	int n = term.scrolln, top = term.scrolltop, bot = term.scrollbot;
+
+	if (!n)
+		return;
+	term.scrolln = 0;
+
+	if (bot >= term.row || !xscroll(top, bot, n)) {
+		tsetdirt(top, bot);
+		return;
+	}
+
+	/* the cursor has been moved along with the line it was drawn on */
+	if (BETWEEN(term.ocy, top, bot) && BETWEEN(term.ocy - n, top, bot))
+		tsetdirt(term.ocy - n, term.ocy - n);
+}
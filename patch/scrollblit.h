@@ -0,0 +1,7 @@
+extern int scrollstale;
+
+void tscrollblit(int, int, int);
+#if SCROLLBACK_PATCH || REFLOW_PATCH
+void tscrollview(int);
+#endif // SCROLLBACK_PATCH | REFLOW_PATCH
+void tscrollblitdraw(void);
@@ -0,0 +1,31 @@
+/*
+ * Moves the lines top to bot up by n lines within the drawing buffer, or down
+ * if n is negative. Returns 0 if the lines have to be redrawn instead.
+ */
+int
+xscroll(int top, int bot, int n)
+{
+	#if ANYSIZE_PATCH
+	int x = win.hborderpx, y = win.vborderpx;
+	#else
+	int x = borderpx, y = borderpx;
+	#endif // ANYSIZE_PATCH
+	int rows = bot - top + 1 - abs(n);
+
+	#if BACKGROUND_IMAGE_PATCH || SINGLE_DRAWABLE_BUFFER_PATCH
+	/* the background image does not scroll with the text, and parts of the
+	 * window that are not visible can not be copied */
+	return 0;
+	#endif // BACKGROUND_IMAGE_PATCH | SINGLE_DRAWABLE_BUFFER_PATCH
+	#if KEYBOARDSELECT_PATCH
+	/* the keyboard select overlays are drawn outside of draw() */
+	if (IS_SET(MODE_KBDSELECT))
+		return 0;
+	#endif // KEYBOARDSELECT_PATCH
+
+	if (rows > 0)
+		XCopyArea(xw.dpy, xw.buf, xw.buf, dc.gc,
+			x, y + (top + MAX(n, 0)) * win.ch, win.tw, rows * win.ch,
+			x, y + (top + MAX(-n, 0)) * win.ch);
+	return 1;
+}
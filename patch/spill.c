@@ -0,0 +1,397 @@
+/*
+ * Lines that fall off the end of the history ring are appended to a file
+ * rather than dropped. The file is created in TMPDIR, unlinked right away
+ * and mapped into memory, so that spilled lines can be read back through
+ * TLINE() like any other history line. Only the offset of every SPILLINDEX-th
+ * line is kept in memory; the lines in between are found by skipping over
+ * the records, each of which starts with its size.
+ *
+ * Spilled lines are decoded into a small cache and are read only; changes
+ * made to them through TLINE() are lost once they leave the cache. The
+ * exception are the highlights of keyboard select search, which are kept
+ * aside for every line that has any when it leaves the cache, and put back
+ * when it is decoded again.
+ *
+ * Spilled lines are not reflowed. When the window is made narrower, the lines
+ * spilled at a wider width are cut at the right edge.
+ */
+#define SPILLINDEX      64
+#define SPILLCACHESIZ   256
+#define SPILLGROW       (1 << 20)
+#if KEYBOARDSELECT_PATCH
+/* the highlights are kept aside */
+#define SPILLMODE(m)    ((m) & ~ATTR_HIGHLIGHT)
+#else
+#define SPILLMODE(m)    (m)
+#endif // KEYBOARDSELECT_PATCH
+
+typedef struct {
+	uint32_t siz;     /* size of the record, a multiple of 4 */
+	ushort ncells;    /* stored cells, the rest of the line is cleared */
+	ushort nruns;     /* attribute runs */
+} SpillRecord;
+
+typedef struct {
+	uint32_t len;
+	uint32_t mode;
+	uint32_t fg;
+	uint32_t bg;
+	#if UNDERCURL_PATCH
+	int ustyle;
+	int ucolor[3];
+	#endif // UNDERCURL_PATCH
+} SpillRun;
+
+static struct {
+	int fd;
+	int failed;
+	char *map;
+	size_t maplen;    /* size of the file and the mapping */
+	size_t len;       /* bytes in use */
+	size_t *index;    /* offset of every SPILLINDEX-th line */
+	int nindex;
+	int indexsiz;
+} spill = { .fd = -1 };
+
+static struct {
+	int k;            /* spilled line + 1, or 0 */
+	int col;
+	Line line;
+} spillcache[SPILLCACHESIZ];
+
+#if KEYBOARDSELECT_PATCH
+typedef struct SpillMark SpillMark;
+struct SpillMark {
+	int k;
+	int col;
+	SpillMark *next;
+	uint32_t bits[];  /* the highlighted cells */
+};
+
+static struct {
+	SpillMark **bucket;
+	int nbucket;      /* a power of 2 */
+	int n;
+} spillmarks;
+
+static SpillMark **
+spillmarkfind(int k)
+{
+	SpillMark **p;
+
+	if (!spillmarks.nbucket)
+		return NULL;
+	for (p = &spillmarks.bucket[k & (spillmarks.nbucket - 1)]; *p; p = &(*p)->next) {
+		if ((*p)->k == k)
+			break;
+	}
+	return p;
+}
+
+static void
+spillmarkgrow(void)
+{
+	SpillMark **bucket, *m, *next;
+	int i, nbucket = MAX(spillmarks.nbucket * 2, 1024);
+
+	bucket = xmalloc(nbucket * sizeof(*bucket));
+	memset(bucket, 0, nbucket * sizeof(*bucket));
+	for (i = 0; i < spillmarks.nbucket; i++) {
+		for (m = spillmarks.bucket[i]; m; m = next) {
+			next = m->next;
+			m->next = bucket[m->k & (nbucket - 1)];
+			bucket[m->k & (nbucket - 1)] = m;
+		}
+	}
+	free(spillmarks.bucket);
+	spillmarks.bucket = bucket;
+	spillmarks.nbucket = nbucket;
+}
+
+/*
+ * Keeps the highlights of the col glyphs of spilled line k aside.
+ */
+static void
+spillkeepmarks(int k, const Glyph *line, int col)
+{
+	SpillMark **p = spillmarkfind(k), *m;
+	size_t siz = (col + 31) / 32 * sizeof(uint32_t);
+	int x;
+
+	for (x = 0; x < col && !(line[x].mode & ATTR_HIGHLIGHT); x++)
+		;
+	if (x == col) {
+		if (p && (m = *p)) {
+			*p = m->next;
+			free(m);
+			spillmarks.n--;
+		}
+		return;
+	}
+
+	if (!p || !*p) {
+		if (spillmarks.n >= 2 * spillmarks.nbucket)
+			spillmarkgrow();
+		p = spillmarkfind(k);
+		*p = xmalloc(sizeof(SpillMark) + siz);
+		(*p)->k = k;
+		(*p)->col = col;
+		(*p)->next = NULL;
+		spillmarks.n++;
+	} else if ((*p)->col != col) {
+		*p = xrealloc(*p, sizeof(SpillMark) + siz);
+		(*p)->col = col;
+	}
+	m = *p;
+	memset(m->bits, 0, siz);
+	for (; x < col; x++) {
+		if (line[x].mode & ATTR_HIGHLIGHT)
+			m->bits[x / 32] |= 1u << (x % 32);
+	}
+}
+
+static void
+spillfreemarks(void)
+{
+	SpillMark *m, *next;
+	int i;
+
+	for (i = 0; i < spillmarks.nbucket; i++) {
+		for (m = spillmarks.bucket[i]; m; m = next) {
+			next = m->next;
+			free(m);
+		}
+		spillmarks.bucket[i] = NULL;
+	}
+	spillmarks.n = 0;
+}
+#endif // KEYBOARDSELECT_PATCH
+
+static int
+spillattrcmp(const Glyph *a, const Glyph *b)
+{
+	return SPILLMODE(a->mode) != SPILLMODE(b->mode) || a->fg != b->fg || a->bg != b->bg
+	#if UNDERCURL_PATCH
+		|| a->ustyle != b->ustyle || a->ucolor[0] != b->ucolor[0]
+		|| a->ucolor[1] != b->ucolor[1] || a->ucolor[2] != b->ucolor[2]
+	#endif // UNDERCURL_PATCH
+		;
+}
+
+static void
+spillfail(const char *what)
+{
+	fprintf(stderr, "spill: %s: %s, no longer keeping old history\n",
+		what, strerror(errno));
+	spill.failed = 1;
+}
+
+static int
+spillopen(void)
+{
+	char path[PATH_MAX];
+	const char *dir = getenv("TMPDIR");
+
+	snprintf(path, sizeof(path), "%s/st-spill-XXXXXX", dir ? dir : "/tmp");
+	if ((spill.fd = mkstemp(path)) < 0) {
+		spillfail("mkstemp");
+		return 0;
+	}
+	unlink(path);
+	fcntl(spill.fd, F_SETFD, FD_CLOEXEC);
+	return 1;
+}
+
+/*
+ * Makes room for need bytes in the file. The blocks are allocated up front so
+ * that running out of disk space does not end in a SIGBUS when writing.
+ */
+static int
+spillgrow(size_t need)
+{
+	size_t siz = MAX(spill.maplen * 2, SPILLGROW);
+	char *map;
+	int err;
+
+	while (siz < need)
+		siz *= 2;
+	if ((err = posix_fallocate(spill.fd, 0, siz))) {
+		errno = err;
+		spillfail("posix_fallocate");
+		return 0;
+	}
+	map = mmap(NULL, siz, PROT_READ | PROT_WRITE, MAP_SHARED, spill.fd, 0);
+	if (map == MAP_FAILED) {
+		spillfail("mmap");
+		return 0;
+	}
+	if (spill.map)
+		munmap(spill.map, spill.maplen);
+	spill.map = map;
+	spill.maplen = siz;
+	return 1;
+}
+
+/*
+ * Appends a line of col glyphs to the spilled history.
+ *
+ * Returns 1 if the line was spilled.
+ */
+int
+spillappend(const Glyph *line, int col)
+{
+	SpillRecord *rec;
+	SpillRun *run;
+	Glyph clear;
+	char *text;
+	size_t siz;
+	int x, n, nruns = 0, width = col;
+
+	if (spill.failed || (spill.fd < 0 && !spillopen()))
+		return 0;
+
+	tclearglyph(&clear, 0);
+	#if UNDERCURL_PATCH
+	clear.ustyle = 0;
+	clear.ucolor[0] = clear.ucolor[1] = clear.ucolor[2] = 0;
+	#endif // UNDERCURL_PATCH
+	while (col > 0 && line[col - 1].u == ' ' && !spillattrcmp(&line[col - 1], &clear))
+		col--;
+	for (x = 0; x < col; x += n, nruns++)
+		for (n = 1; x + n < col && !spillattrcmp(&line[x + n], &line[x]); n++)
+			;
+
+	/* worst case size, the record is trimmed once the text is encoded */
+	siz = sizeof(*rec) + nruns * sizeof(*run) + col * UTF_SIZ + 3;
+	if (spill.len + siz > spill.maplen && !spillgrow(spill.len + siz))
+		return 0;
+
+	rec = (SpillRecord *)(spill.map + spill.len);
+	rec->ncells = col;
+	rec->nruns = nruns;
+	run = (SpillRun *)(rec + 1);
+	for (x = 0; x < col; x += n, run++) {
+		for (n = 1; x + n < col && !spillattrcmp(&line[x + n], &line[x]); n++)
+			;
+		*run = (SpillRun){
+			.len = n, .mode = SPILLMODE(line[x].mode), .fg = line[x].fg, .bg = line[x].bg,
+			#if UNDERCURL_PATCH
+			.ustyle = line[x].ustyle,
+			.ucolor = { line[x].ucolor[0], line[x].ucolor[1], line[x].ucolor[2] },
+			#endif // UNDERCURL_PATCH
+		};
+	}
+	text = (char *)run;
+	for (x = 0; x < col; x++)
+		text += utf8encode(line[x].u, text);
+	rec->siz = (text - (char *)rec + 3) & ~3;
+
+	if (term.histspill % SPILLINDEX == 0) {
+		if (spill.nindex == spill.indexsiz) {
+			spill.indexsiz = MAX(spill.indexsiz * 2, 64);
+			spill.index = xrealloc(spill.index, spill.indexsiz * sizeof(*spill.index));
+		}
+		spill.index[spill.nindex++] = spill.len;
+	}
+	spill.len += rec->siz;
+	#if KEYBOARDSELECT_PATCH
+	spillkeepmarks(term.histspill, line, width);
+	#endif // KEYBOARDSELECT_PATCH
+	term.histspill++;
+
+	return 1;
+}
+
+/*
+ * Returns spilled line k, counting from the oldest, as a line of at least
+ * term.col glyphs.
+ */
+Line
+spillline(int k)
+{
+	const SpillRecord *rec;
+	const SpillRun *run;
+	const char *text;
+	size_t off;
+	Glyph *gp;
+	Rune u;
+	int e = k % SPILLCACHESIZ, x = 0, r, n, i;
+	#if KEYBOARDSELECT_PATCH
+	SpillMark **p;
+	#endif // KEYBOARDSELECT_PATCH
+
+	if (spillcache[e].k == k + 1 && spillcache[e].col == term.col)
+		return spillcache[e].line;
+
+	#if KEYBOARDSELECT_PATCH
+	if (spillcache[e].k)
+		spillkeepmarks(spillcache[e].k - 1, spillcache[e].line, spillcache[e].col);
+	#endif // KEYBOARDSELECT_PATCH
+
+	if (spillcache[e].col != term.col) {
+		spillcache[e].line = xrealloc(spillcache[e].line, term.col * sizeof(Glyph));
+		spillcache[e].col = term.col;
+	}
+	spillcache[e].k = k + 1;
+	gp = spillcache[e].line;
+
+	off = spill.index[k / SPILLINDEX];
+	for (i = k - k % SPILLINDEX; i < k; i++)
+		off += ((const SpillRecord *)(spill.map + off))->siz;
+	rec = (const SpillRecord *)(spill.map + off);
+	run = (const SpillRun *)(rec + 1);
+	text = (const char *)(run + rec->nruns);
+
+	for (r = 0; r < rec->nruns; r++, run++) {
+		for (n = run->len; n > 0 && x < term.col; n--, x++) {
+			text += utf8decode(text, &u, UTF_SIZ);
+			gp[x] = (Glyph){
+				.u = u, .mode = run->mode, .fg = run->fg, .bg = run->bg,
+				#if UNDERCURL_PATCH
+				.ustyle = run->ustyle,
+				.ucolor = { run->ucolor[0], run->ucolor[1], run->ucolor[2] },
+				#endif // UNDERCURL_PATCH
+			};
+		}
+	}
+	for (; x < term.col; x++)
+		tclearglyph(&gp[x], 0);
+
+	#if KEYBOARDSELECT_PATCH
+	if ((p = spillmarkfind(k)) && *p) {
+		for (x = 0; x < MIN((*p)->col, term.col); x++) {
+			if ((*p)->bits[x / 32] & (1u << (x % 32)))
+				gp[x].mode |= ATTR_HIGHLIGHT;
+		}
+	}
+	#endif // KEYBOARDSELECT_PATCH
+
+	return gp;
+}
+
+/*
+ * Drops all spilled lines and gives the disk space back.
+ */
+void
+spillclear(void)
+{
+	int i;
+
+	term.histspill = 0;
+	for (i = 0; i < SPILLCACHESIZ; i++)
+		spillcache[i].k = 0;
+	#if KEYBOARDSELECT_PATCH
+	spillfreemarks();
+	#endif // KEYBOARDSELECT_PATCH
+	if (spill.fd < 0)
+		return;
+
+	if (spill.map)
+		munmap(spill.map, spill.maplen);
+	if (ftruncate(spill.fd, 0) < 0)
+		fprintf(stderr, "spill: ftruncate: %s\n", strerror(errno));
+	spill.map = NULL;
+	spill.maplen = 0;
+	spill.len = 0;
+	spill.nindex = 0;
+}
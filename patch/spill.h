@@ -0,0 +1,5 @@
+#include <sys/mman.h>
+
+int spillappend(const Glyph *, int);
+Line spillline(int);
+void spillclear(void);
@@ -1,10 +1,37 @@
 /* Patches */
+#if ASCII_FASTPATH_PATCH
+#include "asciifastpath.c"
+#endif
+#if BENCHMARK_PATCH
+#include "benchmark.c"
+#endif
+#if CSIPARSER_PATCH
+#include "csiparser.c"
+#endif
+#if REFLOW_PATCH && COMPACT_GLYPH_PATCH
+#include "compactglyph.c"
+#endif
+#if REFLOW_PATCH && COMPACT_GLYPH_PATCH && COMPRESSED_HISTORY_PATCH
+#include "histcompress.c"
+#endif
 #if COPYURL_PATCH || COPYURL_HIGHLIGHT_SELECTED_URLS_PATCH
 #include "copyurl.c"
 #endif
+#if DIRTY_SPAN_PATCH
+#include "dirtyspan.c"
+#endif
+#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+#include "dynamichistory.c"
+#endif
 #if EXTERNALPIPE_PATCH
 #include "externalpipe.c"
 #endif
+#if FAST_SCROLL_PATCH
+#include "fastscroll.c"
+#endif
+#if REFLOW_PATCH && INCREMENTAL_REFLOW_PATCH
+#include "incrementalreflow.c"
+#endif
 #if ISO14755_PATCH
 #include "iso14755.c"
 #endif
@@ -13,6 +40,12 @@
 #elif KEYBOARDSELECT_PATCH
 #include "keyboardselect_st.c"
 #endif
+#if REFLOW_PATCH && KEYBOARDSELECT_PATCH && INDEXED_SEARCH_PATCH
+#include "indexedsearch.c"
+#endif
+#if REFLOW_PATCH && KEYBOARDSELECT_PATCH && REGEX_SEARCH_PATCH
+#include "regexsearch.c"
+#endif
 #if RIGHTCLICKTOPLUMB_PATCH
 #include "rightclicktoplumb_st.c"
 #endif
@@ -24,9 +57,38 @@
 #elif SCROLLBACK_PATCH || SCROLLBACK_MOUSE_PATCH || SCROLLBACK_MOUSE_ALTSCREEN_PATCH
 #include "scrollback.c"
 #endif
+#if SCROLL_BLIT_PATCH
+#include "scrollblit.c"
+#endif
+#if REFLOW_PATCH && SCROLLBACK_SPILL_PATCH
+#include "spill.c"
+#endif
+#if STRSTREAM_PATCH
+#include "strstream.c"
+#endif
 #if SYNC_PATCH
 #include "sync.c"
 #endif
+#if TTY_THREAD_PATCH
+#include "ttythread.c"
+#elif TTY_RINGBUFFER_PATCH
+#include "ttyringbuffer.c"
+#endif
+#if TTY_WRITEQUEUE_PATCH
+#include "ttywritequeue.c"
+#endif
+#if STREAMING_PASTE_PATCH
+#include "streampaste.c"
+#endif
 #if OSC7_PATCH
 #include "osc7.c"
 #endif
+#if OSC8_PATCH
+#include "osc8.c"
+#endif
+#if REFLOW_PATCH && URL_CACHE_PATCH
+#include "urlcache.c"
+#endif
+#if UTF8_SIMD_PATCH
+#include "utf8simd.c"
+#endif
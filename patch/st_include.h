@@ -1,10 +1,37 @@
 /* Patches */
+#if ASCII_FASTPATH_PATCH
+#include "asciifastpath.h"
+#endif
+#if BENCHMARK_PATCH
+#include "benchmark.h"
+#endif
+#if CSIPARSER_PATCH
+#include "csiparser.h"
+#endif
+#if REFLOW_PATCH && COMPACT_GLYPH_PATCH
+#include "compactglyph.h"
+#endif
+#if REFLOW_PATCH && COMPACT_GLYPH_PATCH && COMPRESSED_HISTORY_PATCH
+#include "histcompress.h"
+#endif
 #if COPYURL_PATCH || COPYURL_HIGHLIGHT_SELECTED_URLS_PATCH
 #include "copyurl.h"
 #endif
+#if DIRTY_SPAN_PATCH
+#include "dirtyspan.h"
+#endif
+#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+#include "dynamichistory.h"
+#endif
 #if EXTERNALPIPE_PATCH
 #include "externalpipe.h"
 #endif
+#if FAST_SCROLL_PATCH
+#include "fastscroll.h"
+#endif
+#if REFLOW_PATCH && INCREMENTAL_REFLOW_PATCH
+#include "incrementalreflow.h"
+#endif
 #if ISO14755_PATCH
 #include "iso14755.h"
 #endif
@@ -13,6 +40,12 @@
 #elif KEYBOARDSELECT_PATCH
 #include "keyboardselect_st.h"
 #endif
+#if REFLOW_PATCH && KEYBOARDSELECT_PATCH && INDEXED_SEARCH_PATCH
+#include "indexedsearch.h"
+#endif
+#if REFLOW_PATCH && KEYBOARDSELECT_PATCH && REGEX_SEARCH_PATCH
+#include "regexsearch.h"
+#endif
 #if OPENURLONCLICK_PATCH
 #include "openurlonclick.h"
 #endif
@@ -27,9 +60,35 @@
 #elif SCROLLBACK_PATCH || SCROLLBACK_MOUSE_PATCH || SCROLLBACK_MOUSE_ALTSCREEN_PATCH
 #include "scrollback.h"
 #endif
+#if SCROLL_BLIT_PATCH
+#include "scrollblit.h"
+#endif
+#if REFLOW_PATCH && SCROLLBACK_SPILL_PATCH
+#include "spill.h"
+#endif
+#if STRSTREAM_PATCH
+#include "strstream.h"
+#endif
 #if SYNC_PATCH
 #include "sync.h"
 #endif
+#if TTY_THREAD_PATCH
+#include "ttythread.h"
+#elif TTY_RINGBUFFER_PATCH
+#include "ttyringbuffer.h"
+#endif
+#if UNICODE_WIDTH_PATCH
+#include "unicodewidth.h"
+#endif
 #if OSC7_PATCH
 #include "osc7.h"
 #endif
+#if OSC8_PATCH
+#include "osc8.h"
+#endif
+#if REFLOW_PATCH && URL_CACHE_PATCH
+#include "urlcache.h"
+#endif
+#if UTF8_SIMD_PATCH
+#include "utf8simd.h"
+#endif
@@ -0,0 +1,59 @@
+/*
+ * A streamed paste can take a while to be written out, and keystrokes or the
+ * replies to queries that are written meanwhile would end up between the
+ * bracketed paste markers, where the application takes them for pasted text.
+ * They are held back from when the start marker is written until the end
+ * marker has been written.
+ */
+static struct {
+	char *buf;
+	size_t len;
+	size_t size;
+	int hold;     /* a bracketed paste is being written */
+	int pasting;  /* ttypaste() is writing */
+} ttyheld;
+
+/*
+ * Writes part of the paste, or one of its markers, to the tty.
+ */
+void
+ttypaste(const char *s, size_t n, int may_echo)
+{
+	ttyheld.pasting = 1;
+	ttywrite(s, n, may_echo);
+	ttyheld.pasting = 0;
+}
+
+/*
+ * Starts holding back other input, or stops and writes out what was held.
+ */
+void
+ttypastehold(int hold)
+{
+	size_t len = ttyheld.len;
+
+	ttyheld.hold = hold;
+	if (hold || !len)
+		return;
+	ttyheld.len = 0;
+	ttywrite(ttyheld.buf, len, 0);
+}
+
+/*
+ * Holds s back if a paste is being written, called by ttywrite().
+ *
+ * Returns 1 if it was held back.
+ */
+int
+ttypasteheld(const char *s, size_t n)
+{
+	if (!ttyheld.hold || ttyheld.pasting)
+		return 0;
+	if (ttyheld.len + n > ttyheld.size) {
+		ttyheld.size = MAX(ttyheld.len + n, ttyheld.size * 2);
+		ttyheld.buf = xrealloc(ttyheld.buf, ttyheld.size);
+	}
+	memcpy(ttyheld.buf + ttyheld.len, s, n);
+	ttyheld.len += n;
+	return 1;
+}
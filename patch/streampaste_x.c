@@ -0,0 +1,289 @@
+/*
+ * Pastes are passed on to the shell one property chunk at a time as they are
+ * read from the X server. When the tty write queue is backed up we stop
+ * reading the property, which for INCR transfers also means not asking the
+ * selection owner for the next chunk, and carry on from run() once the shell
+ * has caught up.
+ *
+ * Other input is held back while a bracketed paste is written, so a paste is
+ * cut short rather than left to hang: when a key is pressed, when the owner of
+ * an INCR transfer goes away or has not sent a chunk for pastetimeout ms, and
+ * when the property can not be read.
+ */
+static struct {
+	Atom selection;
+	Atom property;
+	ulong ofs;
+	int incr;     /* INCR transfer in progress */
+	int active;   /* bracketed paste start marker sent */
+	int waiting;  /* waiting for the tty write queue to drain */
+	Window owner; /* selection owner watched for going away */
+	int watching;
+	struct timespec last; /* last chunk of the INCR transfer */
+	#if KEYBOARDSELECT_PATCH && REFLOW_PATCH
+	int append;
+	#endif // KEYBOARDSELECT_PATCH
+} paste;
+
+static void
+pastepropertymask(int set)
+{
+	#if BACKGROUND_IMAGE_PATCH
+	if (pseudotransparency)
+		return;
+	#endif // BACKGROUND_IMAGE_PATCH
+	MODBIT(xw.attrs.event_mask, set, PropertyChangeMask);
+	XChangeWindowAttributes(xw.dpy, xw.win, CWEventMask, &xw.attrs);
+}
+
+static int pasteerror;
+
+static int
+pasteerrorhandler(Display *dpy, XErrorEvent *e)
+{
+	pasteerror = 1;
+	return 0;
+}
+
+/*
+ * Selects or deselects the structure events of the selection owner, which may
+ * already be gone.
+ *
+ * Returns 0 if the owner is gone.
+ */
+static int
+pastewatch(Window owner, int watch)
+{
+	XErrorHandler old = XSetErrorHandler(pasteerrorhandler);
+
+	pasteerror = 0;
+	XSelectInput(xw.dpy, owner, watch ? StructureNotifyMask : NoEventMask);
+	XSync(xw.dpy, False);
+	XSetErrorHandler(old);
+	return !pasteerror;
+}
+
+static void
+pastemarker(int end)
+{
+	#if KEYBOARDSELECT_PATCH && REFLOW_PATCH
+	if (IS_SET(MODE_KBDSELECT) && kbds_issearchmode()) {
+		if (end)
+			ttypastehold(0);
+		return;
+	}
+	#endif // KEYBOARDSELECT_PATCH
+	if (end && paste.active && IS_SET(MODE_BRCKTPASTE)) {
+		ttypaste("\033[201~", 6, 0);
+	} else if (!end && !paste.active && IS_SET(MODE_BRCKTPASTE)) {
+		ttypaste("\033[200~", 6, 0);
+		/* keep other input out of the paste until the end marker */
+		ttypastehold(1);
+	}
+	if (end)
+		ttypastehold(0);
+	paste.active = !end;
+}
+
+/*
+ * Cuts short the paste in progress, if any.
+ */
+static void
+pastecancel(void)
+{
+	if (paste.incr) {
+		paste.incr = 0;
+		pastepropertymask(0);
+	}
+	if (paste.watching) {
+		paste.watching = 0;
+		pastewatch(paste.owner, 0);
+	}
+	paste.waiting = 0;
+	pastemarker(1);
+}
+
+static void
+pastedata(uchar *data, ulong len)
+{
+	uchar *repl, *last;
+
+	#if KEYBOARDSELECT_PATCH && REFLOW_PATCH
+	if (IS_SET(MODE_KBDSELECT) && kbds_issearchmode()) {
+		kbds_pasteintosearch(data, len, paste.append++);
+		return;
+	}
+	#endif // KEYBOARDSELECT_PATCH
+
+	/*
+	 * As seen in getsel:
+	 * Line endings are inconsistent in the terminal and GUI world
+	 * copy and pasting. When receiving some selection data,
+	 * replace all '\n' with '\r'.
+	 * FIXME: Fix the computer world.
+	 */
+	repl = data;
+	last = data + len;
+	while ((repl = memchr(repl, '\n', last - repl))) {
+		*repl++ = '\r';
+	}
+
+	pastemarker(0);
+	ttypaste((char *)data, len, 1);
+}
+
+static void
+pasteread(void)
+{
+	ulong nitems, rem;
+	int format;
+	uchar *data;
+	Atom type, incratom = XInternAtom(xw.dpy, "INCR", 0);
+
+	paste.waiting = 0;
+	clock_gettime(CLOCK_MONOTONIC, &paste.last);
+	do {
+		#if TTY_WRITEQUEUE_PATCH
+		if (ttywritepending()) {
+			paste.waiting = 1;
+			return;
+		}
+		#endif // TTY_WRITEQUEUE_PATCH
+
+		if (XGetWindowProperty(xw.dpy, xw.win, paste.property, paste.ofs,
+					BUFSIZ/4, False, AnyPropertyType,
+					&type, &format, &nitems, &rem,
+					&data)) {
+			fprintf(stderr, "Clipboard allocation failed\n");
+			pastecancel();
+			return;
+		}
+
+		if (type == incratom) {
+			/*
+			 * Activate the PropertyNotify events so we receive
+			 * when the selection owner does send us the next
+			 * chunk of data. Deleting the property is the
+			 * transfer start signal.
+			 */
+			XFree(data);
+			paste.incr = 1;
+			pastepropertymask(1);
+			/* only other clients' windows are watched */
+			paste.owner = XGetSelectionOwner(xw.dpy, paste.selection);
+			if (paste.owner == xw.win)
+				paste.owner = None;
+			#if ST_EMBEDDER_PATCH
+			if (paste.owner == embed)
+				paste.owner = None;
+			#endif // ST_EMBEDDER_PATCH
+			if (paste.owner != None) {
+				paste.watching = 1;
+				if (!pastewatch(paste.owner, 1)) {
+					paste.watching = 0;
+					pastecancel();
+					return;
+				}
+			}
+			break;
+		}
+
+		if (paste.incr && nitems == 0) {
+			/*
+			 * A chunk with no data is the signal of the selection
+			 * owner that all data has been transferred.
+			 */
+			XFree(data);
+			pastecancel();
+			break;
+		}
+
+		if (nitems)
+			pastedata(data, nitems * format / 8);
+		XFree(data);
+		/* number of 32-bit chunks returned */
+		paste.ofs += nitems * format / 32;
+	} while (rem > 0);
+
+	if (!paste.incr)
+		pastemarker(1);
+
+	/*
+	 * Deleting the property again tells the selection owner to send the
+	 * next data chunk in the property.
+	 */
+	paste.ofs = 0;
+	XDeleteProperty(xw.dpy, xw.win, (int)paste.property);
+}
+
+static void
+pastenotify(XEvent *e, Atom property)
+{
+	if (e->type == PropertyNotify) {
+		/* only the chunks of an INCR transfer are of interest here */
+		if (!paste.incr || paste.waiting || property != paste.property)
+			return;
+	} else {
+		/* a new paste cuts short whatever was still being pasted */
+		pastecancel();
+		if (paste.property != None && paste.property != property)
+			XDeleteProperty(xw.dpy, xw.win, (int)paste.property);
+		paste.selection = e->xselection.selection;
+		paste.owner = None;
+		paste.property = property;
+		paste.ofs = 0;
+		#if KEYBOARDSELECT_PATCH && REFLOW_PATCH
+		paste.append = 0;
+		#endif // KEYBOARDSELECT_PATCH
+	}
+
+	pasteread();
+}
+
+static void
+pasteresume(void)
+{
+	if (paste.waiting)
+		pasteread();
+}
+
+/*
+ * Handles the events of the watched selection owner, which are not meant for
+ * the handlers of the terminal window.
+ *
+ * Returns 1 if the event was for the owner.
+ */
+static int
+pasteownerevent(XEvent *e)
+{
+	if (paste.owner == None || e->xany.window != paste.owner)
+		return 0;
+	if (e->type == DestroyNotify && paste.watching) {
+		paste.watching = 0;
+		pastecancel();
+	}
+	return 1;
+}
+
+/*
+ * Gives up on an INCR transfer once the owner has not sent a chunk for
+ * pastetimeout ms.
+ */
+static void
+pasteexpire(struct timespec now)
+{
+	if (paste.incr && !paste.waiting && TIMEDIFF(now, paste.last) >= pastetimeout)
+		pastecancel();
+}
+
+/*
+ * Returns the time in ms until an INCR transfer is given up on, or -1 if there
+ * is none.
+ */
+static double
+pastetimeleft(struct timespec now)
+{
+	if (!paste.incr || paste.waiting)
+		return -1;
+	return MAX(pastetimeout - TIMEDIFF(now, paste.last), 0);
+}
@@ -0,0 +1,6 @@
+static void pastenotify(XEvent *, Atom);
+static void pasteresume(void);
+static void pastecancel(void);
+static int pasteownerevent(XEvent *);
+static void pasteexpire(struct timespec);
+static double pastetimeleft(struct timespec);
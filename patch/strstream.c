@@ -0,0 +1,263 @@
+/*
+ * String sequences (OSC, DCS, APC and PM) are passed on a run of bytes at a
+ * time rather than one rune at a time. Once the selection parameter of an
+ * OSC 52 sequence has been read the base64 payload is decoded as it arrives
+ * instead of being stored, so that a large clipboard push never needs the
+ * encoded data in memory. Sequences longer than strmaxlen bytes are dropped
+ * as soon as they grow past it.
+ */
+static struct {
+	size_t total;      /* bytes seen for the current sequence */
+	int aborted;       /* sequence exceeded strmaxlen, or is not wanted */
+	int osc52;         /* decoding an OSC 52 payload */
+	int done;          /* end of the base64 payload seen */
+	int n;             /* base64 digits in quad */
+	int quad[4];
+	char *buf;         /* decoded payload */
+	size_t len;
+	size_t siz;
+} strstream;
+
+/* as in base64dec(), invalid digits decode as 0 and padding as -1 */
+static const char strb64digits[256] = {
+	[43] = 62, 0, 0, 0, 63, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61,
+	0, 0, 0, -1, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+	13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 0, 0, 0, 0,
+	0, 0, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39,
+	40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
+};
+
+static void
+strb64quad(void)
+{
+	int *q = strstream.quad;
+	char *dst = strstream.buf + strstream.len;
+
+	strstream.n = 0;
+	if (q[0] == -1 || q[1] == -1) {
+		strstream.done = 1;
+		return;
+	}
+	*dst++ = (q[0] << 2) | ((q[1] & 0x30) >> 4);
+	if (q[2] == -1) {
+		strstream.done = 1;
+	} else {
+		*dst++ = ((q[1] & 0x0f) << 4) | ((q[2] & 0x3c) >> 2);
+		if (q[3] == -1)
+			strstream.done = 1;
+		else
+			*dst++ = ((q[2] & 0x03) << 6) | q[3];
+	}
+	strstream.len = dst - strstream.buf;
+}
+
+/* emulate padding if the payload ends early, as base64dec() does */
+static void
+strb64pad(void)
+{
+	if (strstream.n && !strstream.done) {
+		while (strstream.n < 4)
+			strstream.quad[strstream.n++] = -1;
+		strb64quad();
+	}
+	strstream.done = 1;
+}
+
+static size_t
+strb64decode_scalar(const uchar *s, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len && !strstream.done; i++) {
+		/* skip non-printable characters as base64dec_getc() does */
+		if (!BETWEEN(s[i], 0x20, 0x7e))
+			continue;
+		/* strparse() would have ended the argument here */
+		if (s[i] == ';') {
+			strb64pad();
+			break;
+		}
+		strstream.quad[strstream.n++] = strb64digits[s[i]];
+		if (strstream.n == 4)
+			strb64quad();
+	}
+
+	return len;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * Decodes 16 base64 digits into 12 bytes at a time, see
+ * http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html
+ * Blocks containing anything but base64 digits, such as padding or line
+ * breaks, are left to the scalar decoder.
+ */
+__attribute__((target("ssse3")))
+static size_t
+strb64decode_ssse3(const uchar *s, size_t len)
+{
+	const __m128i lut_lo = _mm_setr_epi8(
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+		0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const __m128i lut_hi = _mm_setr_epi8(
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i lut_roll = _mm_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i pack = _mm_setr_epi8(
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	const __m128i mask_2f = _mm_set1_epi8(0x2f), zero = _mm_setzero_si128();
+	__m128i v, hi, lo, roll;
+	size_t i = 0;
+
+	while (i + 16 <= len && !strstream.n && !strstream.done) {
+		v = _mm_loadu_si128((const __m128i *)(s + i));
+		hi = _mm_and_si128(_mm_srli_epi32(v, 4), mask_2f);
+		lo = _mm_and_si128(v, mask_2f);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(
+				_mm_shuffle_epi8(lut_lo, lo),
+				_mm_shuffle_epi8(lut_hi, hi)), zero)) != 0xffff) {
+			strb64decode_scalar(s + i, 16);
+			i += 16;
+			continue;
+		}
+		roll = _mm_shuffle_epi8(lut_roll,
+			_mm_add_epi8(_mm_cmpeq_epi8(v, mask_2f), hi));
+		v = _mm_add_epi8(v, roll);
+		v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+		v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+		v = _mm_shuffle_epi8(v, pack);
+		_mm_storeu_si128((__m128i *)(strstream.buf + strstream.len), v);
+		strstream.len += 12;
+		i += 16;
+	}
+
+	return i + strb64decode_scalar(s + i, len - i);
+}
+#endif
+
+static void
+strb64decode(const char *s, size_t len)
+{
+	static size_t (*decode)(const uchar *, size_t) = NULL;
+
+	if (!decode) {
+		decode = strb64decode_scalar;
+		#if defined(__x86_64__) || defined(__i386__)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("ssse3"))
+			decode = strb64decode_ssse3;
+		#endif
+	}
+
+	/* room for 3 bytes per 4 digits, and the 16 byte vector stores */
+	if (strstream.len + len / 4 * 3 + 16 > strstream.siz) {
+		strstream.siz = MAX(strstream.len + len / 4 * 3 + 16, strstream.siz * 2);
+		strstream.buf = xrealloc(strstream.buf, strstream.siz);
+	}
+	decode((const uchar *)s, len);
+}
+
+/*
+ * Appends bytes to the current string sequence.
+ */
+void
+strput(const char *s, size_t len)
+{
+	size_t i;
+
+	if (strstream.aborted)
+		return;
+	strstream.total += len;
+	if (strmaxlen && strstream.total > strmaxlen) {
+		fprintf(stderr, "erresc: string sequence longer than %u bytes\n", strmaxlen);
+		strstreamreset();
+		strstream.aborted = 1;
+		return;
+	}
+
+	if (strstream.osc52) {
+		strb64decode(s, len);
+		return;
+	}
+
+	if (strescseq.len + len >= strescseq.siz) {
+		strescseq.siz = MAX(strescseq.siz * 2, strescseq.len + len + 1);
+		strescseq.buf = xrealloc(strescseq.buf, strescseq.siz);
+	}
+	memcpy(&strescseq.buf[strescseq.len], s, len);
+	strescseq.len += len;
+
+	/* start decoding OSC 52 data once the selection parameter is known */
+	if (strescseq.type != ']' || strescseq.len < 4 ||
+	    strncmp(strescseq.buf, "52;", 3))
+		return;
+	for (i = MAX(3, strescseq.len - len); i < strescseq.len; i++) {
+		if (strescseq.buf[i] != ';')
+			continue;
+		if (!allowwindowops) {
+			strstream.aborted = 1;
+			return;
+		}
+		strstream.osc52 = 1;
+		strb64decode(strescseq.buf + i + 1, strescseq.len - i - 1);
+		strescseq.len = i + 1;
+		return;
+	}
+}
+
+/*
+ * Appends a run of printable ASCII characters to the current string sequence,
+ * doing the same as calling tputc() for each of them.
+ *
+ * Returns the number of bytes consumed, or 0 if the fast path does not apply.
+ */
+int
+strputrun(const char *s, int len)
+{
+	int n;
+
+	if (!(term.esc & ESC_STR) || IS_SET(MODE_PRINT))
+		return 0;
+	#if SIXEL_PATCH
+	if (term.esc & ESC_DCS)
+		return 0;
+	#endif // SIXEL_PATCH
+
+	for (n = 0; n < len && BETWEEN((uchar)s[n], 0x20, 0x7e); n++)
+		;
+	strput(s, n);
+	return n;
+}
+
+void
+strstreamreset(void)
+{
+	free(strstream.buf);
+	memset(&strstream, 0, sizeof(strstream));
+}
+
+int
+strstreamaborted(void)
+{
+	return strstream.aborted;
+}
+
+/*
+ * Returns the decoded OSC 52 payload, which is then owned by the caller, or
+ * NULL if there is none.
+ */
+char *
+strstreamosc52(void)
+{
+	char *dec;
+
+	if (!strstream.osc52)
+		return NULL;
+	strb64pad();
+	strstream.buf[strstream.len] = '\0';
+	dec = strstream.buf;
+	strstream.buf = NULL;
+	strstream.osc52 = 0;
+	return dec;
+}
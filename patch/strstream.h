@@ -0,0 +1,9 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+static void strput(const char *, size_t);
+static int strputrun(const char *, int);
+static void strstreamreset(void);
+static int strstreamaborted(void);
+static char *strstreamosc52(void);
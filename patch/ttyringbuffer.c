@@ -0,0 +1,96 @@
+/*
+ * Reads the output of the shell into a ring buffer of ttyringsize bytes and
+ * passes what has been read to twrite() without copying it around.
+ *
+ * The read size starts at BUFSIZ and doubles for as long as the reads come
+ * back full, and is halved again when they fall short. A partial UTF-8
+ * sequence at the very end of the ring is copied into the few spare bytes
+ * kept before the start of the ring so that it can be handed to twrite()
+ * together with the rest of the sequence at the start of the ring.
+ */
+size_t
+ttyread(void)
+{
+	static char *buf = NULL;
+	static size_t head = 0, tail = 0, rdsize = BUFSIZ;
+	static int parsing = 0;
+	size_t size = ttyringsize, mask = size - 1, pos, len, want;
+	struct iovec iov[2];
+	ssize_t ret = 1;
+	int written;
+	char *p;
+
+	if (!buf) {
+		if (!size || (size & mask))
+			die("ttyringsize must be a power of two\n");
+		buf = (char *)xmalloc(UTF_SIZ + size) + UTF_SIZ;
+		rdsize = MIN(rdsize, size);
+	}
+
+	#if SYNC_PATCH
+	if (!twrite_aborted && (want = MIN(size - (head - tail), rdsize)))
+	#else
+	if ((want = MIN(size - (head - tail), rdsize)))
+	#endif // SYNC_PATCH
+	{
+		pos = head & mask;
+		iov[0].iov_base = buf + pos;
+		iov[0].iov_len = MIN(want, size - pos);
+		iov[1].iov_base = buf;
+		iov[1].iov_len = want - iov[0].iov_len;
+
+		switch ((ret = readv(cmdfd, iov, iov[1].iov_len ? 2 : 1))) {
+		case 0:
+			/* let the outer call finish parsing what is left first */
+			if (parsing)
+				return 1;
+			exit(0);
+		case -1:
+			#if TTY_WRITEQUEUE_PATCH
+			if (errno == EAGAIN) {
+				ret = 0;
+				break;
+			}
+			#endif // TTY_WRITEQUEUE_PATCH
+			die("couldn't read from shell: %s\n", strerror(errno));
+		}
+		head += ret;
+
+		if ((size_t)ret == want && want == rdsize)
+			rdsize = MIN(rdsize * 2, size);
+		else if ((size_t)ret < rdsize / 2)
+			rdsize = MIN(MAX(rdsize / 2, BUFSIZ), size);
+	}
+
+	/*
+	 * ttywrite() reads from the shell while writing replies to it, any output
+	 * read then is parsed by the outer call once it is done with the current
+	 * span so that it is handled in the right order
+	 */
+	if (parsing)
+		return ret;
+	parsing = 1;
+
+	while (tail < head) {
+		pos = tail & mask;
+		len = MIN(head - tail, size - pos);
+		p = buf + pos;
+		if (len < UTF_SIZ && len < head - tail) {
+			memcpy(buf - len, p, len);
+			p = buf - len;
+			len = head - tail;
+		}
+		written = twrite(p, len, 0);
+		tail += written;
+		#if SYNC_PATCH
+		if (twrite_aborted)
+			break;
+		#endif // SYNC_PATCH
+		/* keep any incomplete UTF-8 byte sequence for the next call */
+		if ((size_t)written < len && tail + (len - written) == head)
+			break;
+	}
+
+	parsing = 0;
+	return ret;
+}
@@ -0,0 +1,215 @@
+/*
+ * The output of the shell is read by a separate thread into a single-producer,
+ * single-consumer ring of ttyringsize bytes. The reader thread only ever moves
+ * head and the main thread only ever moves tail, so no locks are needed.
+ *
+ * The reader thread wakes the main loop through wakefd, which is what run()
+ * selects on instead of the pty. It only signals when the main loop has
+ * consumed the previous wakeup, so a burst of output costs a single write.
+ * When the ring is full the reader thread waits on spacefd until ttyread()
+ * has made room. Term is only ever touched by the main thread.
+ *
+ * Both handshakes store one variable and then read the other, while the other
+ * thread does the same the other way round. A seq_cst fence sits between the
+ * store and the load on each side, otherwise both threads can miss the other's
+ * store and the wakeup is lost.
+ */
+static char *ttybuf;
+static size_t ttysize;
+static _Atomic size_t ttyhead, ttytail;
+static atomic_int ttywakeup, ttywaiting, ttydone;
+static int ttyerrno, ttyreading;
+static int wakefd[2], spacefd[2];
+
+static void
+ttythread_pipe(int fds[2])
+{
+	int i;
+
+	#ifdef __linux__
+	if ((fds[0] = fds[1] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) >= 0)
+		return;
+	#endif // __linux__
+	if (pipe(fds) < 0)
+		die("pipe failed: %s\n", strerror(errno));
+	for (i = 0; i < 2; i++) {
+		fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+		fcntl(fds[i], F_SETFL, O_NONBLOCK);
+	}
+}
+
+static void
+ttythread_signal(int fds[2])
+{
+	uint64_t one = 1;
+
+	while (write(fds[1], &one, sizeof(one)) < 0 && errno == EINTR)
+		;
+}
+
+static void
+ttythread_drain(int fds[2])
+{
+	uint64_t junk[8];
+
+	while (read(fds[0], junk, sizeof(junk)) > 0)
+		;
+}
+
+static void *
+ttythread_reader(void *arg)
+{
+	size_t mask = ttysize - 1, head = 0, pos, room;
+	struct iovec iov[2];
+	struct pollfd pfd = { .fd = spacefd[0], .events = POLLIN };
+	ssize_t ret;
+
+	for (;;) {
+		room = ttysize - (head - atomic_load_explicit(&ttytail, memory_order_acquire));
+		if (!room) {
+			atomic_store(&ttywaiting, 1);
+			atomic_thread_fence(memory_order_seq_cst);
+			if (head - atomic_load(&ttytail) == ttysize)
+				poll(&pfd, 1, -1);
+			atomic_store(&ttywaiting, 0);
+			ttythread_drain(spacefd);
+			continue;
+		}
+
+		pos = head & mask;
+		iov[0].iov_base = ttybuf + pos;
+		iov[0].iov_len = MIN(room, ttysize - pos);
+		iov[1].iov_base = ttybuf;
+		iov[1].iov_len = room - iov[0].iov_len;
+
+		if ((ret = readv(cmdfd, iov, iov[1].iov_len ? 2 : 1)) <= 0) {
+			if (ret < 0 && errno == EINTR)
+				continue;
+			#if TTY_WRITEQUEUE_PATCH
+			if (ret < 0 && errno == EAGAIN) {
+				poll(&(struct pollfd){ .fd = cmdfd, .events = POLLIN }, 1, -1);
+				continue;
+			}
+			#endif // TTY_WRITEQUEUE_PATCH
+			ttyerrno = ret ? errno : 0;
+			atomic_store(&ttydone, 1);
+			ttythread_signal(wakefd);
+			return NULL;
+		}
+
+		head += ret;
+		atomic_store_explicit(&ttyhead, head, memory_order_release);
+		atomic_thread_fence(memory_order_seq_cst);
+		if (!atomic_exchange(&ttywakeup, 1))
+			ttythread_signal(wakefd);
+	}
+}
+
+int
+ttythread(void)
+{
+	pthread_t thread;
+	sigset_t set, oset;
+
+	if (!ttyringsize || (ttyringsize & (ttyringsize - 1)))
+		die("ttyringsize must be a power of two\n");
+	ttysize = ttyringsize;
+	ttybuf = (char *)xmalloc(UTF_SIZ + ttysize) + UTF_SIZ;
+	ttythread_pipe(wakefd);
+	ttythread_pipe(spacefd);
+
+	/* signals such as SIGCHLD are to be handled by the main thread */
+	sigfillset(&set);
+	pthread_sigmask(SIG_SETMASK, &set, &oset);
+	if ((errno = pthread_create(&thread, NULL, ttythread_reader, NULL)))
+		die("pthread_create failed: %s\n", strerror(errno));
+	pthread_detach(thread);
+	pthread_sigmask(SIG_SETMASK, &oset, NULL);
+
+	return wakefd[0];
+}
+
+/*
+ * Returns the fd that becomes readable when there is output for ttyread(), or
+ * -1 if ttyread() is already running further up the stack, e.g. when twrite()
+ * answers a query. ttywriteraw() has to keep reading while it waits for the
+ * pty: a shell that echoes its input stops reading once it can not write, and
+ * it can not write while the ring is full.
+ */
+int
+ttythread_readfd(void)
+{
+	return ttyreading ? -1 : wakefd[0];
+}
+
+/*
+ * Reads the output that has come in while ttywriteraw() waits for the pty.
+ */
+void
+ttythread_catchup(void)
+{
+	ttyread();
+	#if SYNC_PATCH
+	/* there is no wakeup for what twrite() has left in the ring */
+	while (twrite_aborted)
+		ttyread();
+	#endif // SYNC_PATCH
+}
+
+size_t
+ttyread(void)
+{
+	size_t mask = ttysize - 1, head, tail, pos, len, total = 0;
+	int written, done;
+	char *p;
+
+	if (ttyreading)
+		return 0;
+	ttyreading = 1;
+	ttythread_drain(wakefd);
+	atomic_store(&ttywakeup, 0);
+	atomic_thread_fence(memory_order_seq_cst);
+	done = atomic_load(&ttydone);
+	head = atomic_load_explicit(&ttyhead, memory_order_acquire);
+	tail = atomic_load_explicit(&ttytail, memory_order_relaxed);
+
+	while (tail < head) {
+		pos = tail & mask;
+		len = MIN(head - tail, ttysize - pos);
+		p = ttybuf + pos;
+		if (len < UTF_SIZ && len < head - tail) {
+			memcpy(ttybuf - len, p, len);
+			p = ttybuf - len;
+			len = head - tail;
+		}
+		written = twrite(p, len, 0);
+		tail += written;
+		total += written;
+		#if SYNC_PATCH
+		if (twrite_aborted)
+			break;
+		#endif // SYNC_PATCH
+		/* keep any incomplete UTF-8 byte sequence for the next call */
+		if ((size_t)written < len && tail + (len - written) == head)
+			break;
+	}
+
+	atomic_store_explicit(&ttytail, tail, memory_order_release);
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_exchange(&ttywaiting, 0))
+		ttythread_signal(spacefd);
+	ttyreading = 0;
+
+	#if SYNC_PATCH
+	if (done && !twrite_aborted)
+	#else
+	if (done)
+	#endif // SYNC_PATCH
+	{
+		if (!ttyerrno)
+			exit(0);
+		die("couldn't read from shell: %s\n", strerror(ttyerrno));
+	}
+
+	return total;
+}
@@ -0,0 +1,10 @@
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+int ttythread_readfd(void);
+void ttythread_catchup(void);
@@ -0,0 +1,115 @@
+/*
+ * Input for the shell is appended to a queue and written out with
+ * non-blocking writes of whatever the kernel accepts. What is left over is
+ * written from run() once the pty becomes writable again, so pasting a lot of
+ * text or answering many queries does not hold up the rest of the terminal.
+ * Only once more than ttywritemax bytes are queued up do we wait for the
+ * shell to catch up.
+ */
+static struct {
+	char *buf;
+	size_t start;
+	size_t len;
+	size_t size;
+} ttywq;
+
+static void
+ttywriteraw(const char *s, size_t n)
+{
+	static int nonblock = 0;
+	fd_set wfd, rfd;
+	ssize_t r;
+	#if TTY_THREAD_PATCH
+	/* the output of the shell is read through the reader thread */
+	int rfdno = ttythread_readfd();
+	#else
+	int rfdno = cmdfd;
+	#endif // TTY_THREAD_PATCH
+
+	if (!nonblock) {
+		fcntl(cmdfd, F_SETFL, fcntl(cmdfd, F_GETFL) | O_NONBLOCK);
+		nonblock = 1;
+	}
+
+	/* write straight away if nothing is queued up */
+	while (!ttywq.len && n > 0) {
+		if ((r = write(cmdfd, s, n)) < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN)
+				break;
+			die("write error on tty: %s\n", strerror(errno));
+		}
+		s += r;
+		n -= r;
+	}
+	if (!n)
+		return;
+
+	if (ttywq.start + ttywq.len + n > ttywq.size) {
+		memmove(ttywq.buf, ttywq.buf + ttywq.start, ttywq.len);
+		ttywq.start = 0;
+		if (ttywq.len + n > ttywq.size) {
+			ttywq.size = MAX(ttywq.len + n, ttywq.size * 2);
+			ttywq.buf = xrealloc(ttywq.buf, ttywq.size);
+		}
+	}
+	memcpy(ttywq.buf + ttywq.start + ttywq.len, s, n);
+	ttywq.len += n;
+
+	/* too much is queued up, wait for the shell to read some of it */
+	while (ttywq.len > ttywritemax) {
+		FD_ZERO(&wfd);
+		FD_ZERO(&rfd);
+		FD_SET(cmdfd, &wfd);
+		if (rfdno >= 0)
+			FD_SET(rfdno, &rfd);
+
+		if (pselect(MAX(cmdfd, rfdno)+1, &rfd, &wfd, NULL, NULL, NULL) < 0) {
+			if (errno == EINTR)
+				continue;
+			die("select failed: %s\n", strerror(errno));
+		}
+		if (FD_ISSET(cmdfd, &wfd))
+			ttyflush();
+		#if TTY_THREAD_PATCH
+		if (rfdno >= 0 && FD_ISSET(rfdno, &rfd))
+			ttythread_catchup();
+		#else
+		if (FD_ISSET(cmdfd, &rfd))
+			ttyread();
+		#endif // TTY_THREAD_PATCH
+	}
+}
+
+void
+ttyflush(void)
+{
+	ssize_t r;
+
+	while (ttywq.len > 0) {
+		if ((r = write(cmdfd, ttywq.buf + ttywq.start, ttywq.len)) < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN)
+				return;
+			die("write error on tty: %s\n", strerror(errno));
+		}
+		ttywq.start += r;
+		ttywq.len -= r;
+	}
+
+	ttywq.start = 0;
+	/* do not hold on to the memory of a large paste */
+	if (ttywq.size > ttywritemax) {
+		free(ttywq.buf);
+		ttywq.buf = NULL;
+		ttywq.size = 0;
+	}
+}
+
+size_t
+ttywritepending(void)
+{
+	return ttywq.len;
+}
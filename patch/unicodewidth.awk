@@ -0,0 +1,98 @@
+# Generates unicodewidth_table.h from the Unicode Character Database.
+#
+# usage: awk -f unicodewidth.awk EastAsianWidth.txt UnicodeData.txt > unicodewidth_table.h
+#
+# Wide (W) and fullwidth (F) characters are two cells wide. Nonspacing and
+# enclosing marks, format characters (except the soft hyphen and prepended
+# concatenation marks) and the Hangul medial vowels and final consonants take
+# up no cells. Everything else, including unassigned code points outside of
+# the wide blocks, is one cell wide.
+
+function hex(s,    i, n)
+{
+	n = 0;
+	s = toupper(s);
+	for (i = 1; i <= length(s); i++)
+		n = n * 16 + index("0123456789ABCDEF", substr(s, i, 1)) - 1;
+	return n;
+}
+
+function set(from, to, w,    i)
+{
+	for (i = from; i <= to; i++)
+		width[i] = w;
+}
+
+BEGIN {
+	FS = ";";
+	version = "unknown";
+
+	# unassigned code points in these blocks default to wide
+	set(hex("3400"), hex("4DBF"), 2);
+	set(hex("4E00"), hex("9FFF"), 2);
+	set(hex("F900"), hex("FAFF"), 2);
+	set(hex("20000"), hex("2FFFD"), 2);
+	set(hex("30000"), hex("3FFFD"), 2);
+
+	# format characters that are still drawn
+	n = split("00AD 0600 0601 0602 0603 0604 0605 06DD 070F 0890 0891 08E2 110BD 110CD", f, " ");
+	for (i = 1; i <= n; i++)
+		onecell[hex(f[i])] = 1;
+}
+
+FILENAME ~ /EastAsianWidth/ {
+	if (FNR == 1 && match($0, /[0-9]+\.[0-9]+\.[0-9]+/))
+		version = substr($0, RSTART, RLENGTH);
+	sub(/#.*/, "");
+	gsub(/[ \t]/, "");
+	if ($0 == "" || ($2 != "W" && $2 != "F"))
+		next;
+	if (split($1, r, /\.\./) == 2)
+		set(hex(r[1]), hex(r[2]), 2);
+	else
+		width[hex($1)] = 2;
+	next;
+}
+
+FILENAME ~ /UnicodeData/ {
+	c = hex($1);
+	if ($3 == "Mn" || $3 == "Me" || ($3 == "Cf" && !(c in onecell)))
+		width[c] = 0;
+	else if ((c >= hex("1160") && c <= hex("11FF")) || (c >= hex("D7B0") && c <= hex("D7FF")))
+		width[c] = 0;
+}
+
+END {
+	nblocks = 0;
+	for (b = 0; b < 4352; b++) {
+		key = "";
+		for (i = 0; i < 256; i += 4) {
+			v = 0;
+			for (j = 3; j >= 0; j--) {
+				c = b * 256 + i + j;
+				v = v * 4 + ((c in width) ? width[c] : 1);
+			}
+			key = key sprintf("0x%02x,", v);
+		}
+		if (!(key in blockid)) {
+			blockid[key] = nblocks;
+			blocks[nblocks++] = key;
+		}
+		index_[b] = blockid[key];
+	}
+
+	printf("/* Generated by unicodewidth.awk from Unicode %s, do not edit. */\n\n", version);
+	printf("static const unsigned char unicodewidth_index[%d] = {", 4352);
+	for (b = 0; b < 4352; b++)
+		printf("%s%d,", (b % 16) ? " " : "\n\t", index_[b]);
+	printf("\n};\n\n");
+	printf("static const unsigned char unicodewidth_blocks[%d][64] = {\n", nblocks);
+	for (b = 0; b < nblocks; b++) {
+		key = blocks[b];
+		printf("\t{");
+		for (i = 0; i < 64; i++)
+			printf("%s%s", (i % 16) ? " " : "\n\t\t", substr(key, i * 5 + 1, 5));
+		printf("\n\t},\n");
+	}
+	printf("};\n");
+}
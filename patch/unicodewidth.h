@@ -0,0 +1,10 @@
+#include "unicodewidth_table.h"
+
+/* Returns the number of cells a rune takes up, independent of the locale */
+static inline int
+unicodewidth(Rune u)
+{
+	if (u > 0x10FFFF)
+		return 1;
+	return unicodewidth_blocks[unicodewidth_index[u >> 8]][(u & 0xff) >> 2] >> ((u & 3) << 1) & 3;
+}
@@ -0,0 +1,366 @@
+/*
+ * The urls on each row of the screen are found when the row is drawn, and
+ * kept until the row is marked dirty again. A url is a run of url characters
+ * that starts with http:// or https:// on a logical line, that is the rows
+ * joined by wrapping, so the rows of a logical line are always looked at
+ * together. A url that goes over several rows is listed on each of them.
+ *
+ * Rows that have been changed since they were drawn are looked at again when
+ * they are asked about, so the cache is never out of date.
+ */
+typedef struct {
+	UrlSpan u;
+	int x1, x2;         /* cells of the url on this row */
+} UrlPart;
+
+typedef struct {
+	UrlPart *p;
+	int n, siz;
+	int dirty;          /* has to be looked at again though it is not drawn */
+} UrlRow;
+
+static struct {
+	UrlRow *row;
+	int rows;           /* rows the cache was set up for */
+	int stale;          /* all rows have to be looked at again */
+	Rune *r;            /* the logical line looked at last */
+	int *x, *y;
+	int nr, rsiz;
+	UrlSpan *found;
+	int *first, *last;  /* where the urls found are in r */
+	int nfound, foundsiz;
+} uc;
+
+static int
+urlchar(Rune u)
+{
+	/* () and [] can appear in urls, but excluding them here will reduce false
+	 * positives when figuring out where a given url ends. */
+	static char urlchars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+		"abcdefghijklmnopqrstuvwxyz"
+		"0123456789-._~:/?#@!$&'*+,;=%";
+
+	return u > 0 && u < 128 && strchr(urlchars, (int)u) != NULL;
+}
+
+static int
+urlprefix(int i, int end, const char *prefix)
+{
+	for (; *prefix; prefix++, i++) {
+		if (i >= end || uc.r[i] != *prefix)
+			return 0;
+	}
+	return 1;
+}
+
+static int
+urlminrow(void)
+{
+	return IS_SET(MODE_ALTSCREEN) ? 0 : term.scr - term.histf;
+}
+
+static int
+urlmaxrow(void)
+{
+	return IS_SET(MODE_ALTSCREEN) ? term.row - 1 : term.scr + term.row - 1;
+}
+
+/*
+ * Returns the first row of the logical line that row y is part of.
+ */
+static int
+urltop(int y)
+{
+	int min = urlminrow();
+
+	while (y > min && tiswrapped(TLINE(y - 1)))
+		y--;
+	return y;
+}
+
+/*
+ * Finds the urls on the logical line that starts at row top.
+ *
+ * Returns the last row of the logical line.
+ */
+static int
+urlscan(int top)
+{
+	int x, y, len, i, end, last, max = urlmaxrow();
+	Line line;
+
+	uc.nr = uc.nfound = 0;
+	for (y = top;; y++) {
+		line = TLINE(y);
+		len = tlinelen(line);
+		if (uc.nr + len > uc.rsiz) {
+			uc.rsiz = MAX(uc.rsiz * 2, uc.nr + len);
+			uc.r = xrealloc(uc.r, uc.rsiz * sizeof(*uc.r));
+			uc.x = xrealloc(uc.x, uc.rsiz * sizeof(*uc.x));
+			uc.y = xrealloc(uc.y, uc.rsiz * sizeof(*uc.y));
+		}
+		for (x = 0; x < len; x++, uc.nr++) {
+			uc.r[uc.nr] = line[x].u;
+			uc.x[uc.nr] = x;
+			uc.y[uc.nr] = y;
+		}
+		if (y >= max || !tiswrapped(line))
+			break;
+	}
+
+	for (i = 0; i < uc.nr; i = end) {
+		for (end = i; end < uc.nr && urlchar(uc.r[end]); end++)
+			;
+		if (end == i) {
+			end++;
+			continue;
+		}
+		if (!urlprefix(i, end, "http://") && !urlprefix(i, end, "https://"))
+			continue;
+
+		/* Ignore some trailing characters to improve detection. */
+		/* Alacritty and many other terminals also ignore these. */
+		last = end - 1;
+		if (strchr(",.;:?!", (int)uc.r[last]))
+			last--;
+
+		if (uc.nfound == uc.foundsiz) {
+			uc.foundsiz = MAX(uc.foundsiz * 2, 16);
+			uc.found = xrealloc(uc.found, uc.foundsiz * sizeof(*uc.found));
+			uc.first = xrealloc(uc.first, uc.foundsiz * sizeof(*uc.first));
+			uc.last = xrealloc(uc.last, uc.foundsiz * sizeof(*uc.last));
+		}
+		uc.first[uc.nfound] = i;
+		uc.last[uc.nfound] = last;
+		uc.found[uc.nfound++] = (UrlSpan){
+			.x1 = uc.x[i], .y1 = uc.y[i], .x2 = uc.x[last], .y2 = uc.y[last]
+		};
+	}
+	return y;
+}
+
+/*
+ * Looks at the logical line that row y is part of again.
+ *
+ * Returns the last row of the logical line.
+ */
+static int
+urlupdate(int y)
+{
+	int top = urltop(y), bot = urlscan(top), i, k;
+	UrlRow *r;
+
+	for (y = MAX(top, 0); y <= bot && y < term.row; y++)
+		uc.row[y].n = uc.row[y].dirty = 0;
+	for (i = 0; i < uc.nfound; i++) {
+		for (k = uc.first[i]; k <= uc.last[i]; k++) {
+			y = uc.y[k];
+			if (y < 0 || y >= term.row)
+				continue;
+			r = &uc.row[y];
+			if (k > uc.first[i] && uc.y[k - 1] == y) {
+				r->p[r->n - 1].x2 = uc.x[k];
+				continue;
+			}
+			if (r->n == r->siz) {
+				r->siz = MAX(r->siz * 2, 4);
+				r->p = xrealloc(r->p, r->siz * sizeof(*r->p));
+			}
+			r->p[r->n++] = (UrlPart){ .u = uc.found[i], .x1 = uc.x[k], .x2 = uc.x[k] };
+		}
+	}
+	return bot;
+}
+
+/*
+ * Returns 1 if the logical line that row y is part of has been changed since
+ * it was looked at, and sets bot to its last row. The row above the logical
+ * line counts as well because it could have stopped wrapping into it.
+ */
+static int
+urlrowdirty(int y)
+{
+	return BETWEEN(y, 0, term.row - 1) && (term.dirty[y] || uc.row[y].dirty);
+}
+
+static int
+urlisstale(int y, int *bot)
+{
+	int top = urltop(y), max = urlmaxrow(), dirty = uc.stale;
+
+	dirty |= urlrowdirty(top - 1);
+	for (y = top; y < max && tiswrapped(TLINE(y)); y++)
+		dirty |= urlrowdirty(y);
+	*bot = y;
+	return dirty || urlrowdirty(y);
+}
+
+static void
+urlresize(void)
+{
+	int y;
+
+	if (uc.rows == term.row)
+		return;
+	for (y = term.row; y < uc.rows; y++)
+		free(uc.row[y].p);
+	uc.row = xrealloc(uc.row, term.row * sizeof(*uc.row));
+	for (y = uc.rows; y < term.row; y++)
+		uc.row[y] = (UrlRow){ 0 };
+	uc.rows = term.row;
+	uc.stale = 1;
+}
+
+/*
+ * Looks at the rows that are about to be drawn, called by drawregion() before
+ * the dirty flags are cleared.
+ */
+void
+urlcacheupdate(void)
+{
+	int y, bot;
+
+	urlresize();
+	for (y = 0; y < term.row; y = bot + 1) {
+		if (urlisstale(y, &bot))
+			bot = urlupdate(y);
+	}
+	uc.stale = 0;
+}
+
+/*
+ * Moves the urls of rows top to bot along with the dirty flags when the rows
+ * are scrolled up by n, see tscrollblit().
+ */
+void
+urlcachescroll(int top, int bot, int n)
+{
+	int len = bot - top + 1, r = ((n % len) + len) % len, y, i;
+	UrlRow *tmp;
+
+	if (uc.rows != term.row || uc.stale || !r)
+		return;
+
+	tmp = xmalloc(len * sizeof(*tmp));
+	for (y = 0; y < len; y++)
+		tmp[y] = uc.row[top + (y + r) % len];
+	memcpy(uc.row + top, tmp, len * sizeof(*tmp));
+	free(tmp);
+
+	/* the rows that came around from the other end are dirty */
+	for (y = top; y <= bot; y++) {
+		for (i = 0; i < uc.row[y].n; i++) {
+			uc.row[y].p[i].u.y1 -= n;
+			uc.row[y].p[i].u.y2 -= n;
+		}
+	}
+
+	/* the rows at the edges of the region now have other neighbours, and
+	 * the rows scrolled out at the top may not have gone to the history */
+	uc.row[top].dirty = uc.row[bot].dirty = 1;
+	if (bot + 1 < term.row)
+		uc.row[bot + 1].dirty = 1;
+}
+
+/*
+ * Finds the url at cell x of row y.
+ *
+ * Returns 1 if there is one.
+ */
+int
+urlat(int x, int y, UrlSpan *u)
+{
+	UrlPart *p;
+	int i, bot;
+
+	if (uc.rows != term.row || uc.stale)
+		urlcacheupdate();
+	if (!BETWEEN(y, 0, term.row - 1))
+		return 0;
+	if (urlisstale(y, &bot))
+		urlupdate(y);
+
+	for (i = 0; i < uc.row[y].n; i++) {
+		p = &uc.row[y].p[i];
+		if (BETWEEN(x, p->x1, p->x2)) {
+			*u = p->u;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Finds the last url that starts before cell x of row y, going up into the
+ * scrollback history once there are none left on the screen.
+ *
+ * Returns 1 if there is one.
+ */
+int
+urlbefore(int x, int y, UrlSpan *u)
+{
+	UrlPart *p;
+	int i, top, bot, found = 0, min = urlminrow();
+
+	if (uc.rows != term.row || uc.stale)
+		urlcacheupdate();
+	for (y = MIN(y, term.row - 1); y >= 0; y--, x = term.col) {
+		if (urlisstale(y, &bot))
+			urlupdate(y);
+		for (i = 0; i < uc.row[y].n; i++) {
+			p = &uc.row[y].p[i];
+			if (p->u.y1 < y || p->x1 < x) {
+				*u = p->u;
+				found = 1;
+			}
+		}
+		if (found)
+			return 1;
+	}
+
+	/* the rows above the screen are not kept */
+	top = urltop(0);
+	if (!top && min < 0)
+		top = urltop(-1);
+	for (; top < 0; top = urltop(top - 1)) {
+		urlscan(top);
+		for (i = uc.nfound - 1; i >= 0; i--) {
+			if (uc.found[i].y1 < 0) {
+				*u = uc.found[i];
+				return 1;
+			}
+		}
+		if (top <= min)
+			break;
+	}
+	return 0;
+}
+
+/*
+ * Returns the text of the url.
+ */
+char *
+urltext(const UrlSpan *u)
+{
+	static char url[2048];
+	int x = u->x1, y = u->y1, n = 0, len;
+	Line line = TLINE(y);
+
+	len = tlinelen(line);
+	while (n < sizeof(url) - 1) {
+		if (x >= len) {
+			if (++y > u->y2 || y > urlmaxrow())
+				break;
+			line = TLINE(y);
+			len = tlinelen(line);
+			x = 0;
+			continue;
+		}
+		url[n++] = line[x].u;
+		if (y == u->y2 && x == u->x2)
+			break;
+		x++;
+	}
+	url[n] = '\0';
+	return url;
+}
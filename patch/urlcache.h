@@ -0,0 +1,10 @@
+typedef struct {
+	int x1, y1;     /* first cell, the row may be above the screen */
+	int x2, y2;     /* last cell, the row may be below the screen */
+} UrlSpan;
+
+void urlcacheupdate(void);
+void urlcachescroll(int top, int bot, int n);
+int urlat(int x, int y, UrlSpan *u);
+int urlbefore(int x, int y, UrlSpan *u);
+char *urltext(const UrlSpan *u);
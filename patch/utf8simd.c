@@ -0,0 +1,164 @@
+/*
+ * Decodes a single UTF-8 sequence in the same way as utf8decode() does, but
+ * without looping over the utfmask table for the leading byte.
+ *
+ * Returns the number of bytes consumed, or 0 if the input ends in the middle
+ * of an otherwise valid sequence.
+ */
+static inline int
+utf8decodeseq(const char *c, int clen, Rune *u)
+{
+	uchar b = c[0];
+	int i, len;
+	Rune udecoded;
+
+	if (b < 0x80) {
+		*u = b;
+		return 1;
+	} else if (b < 0xC0 || b >= 0xF8) {
+		*u = UTF_INVALID;
+		return 1;
+	} else if (b < 0xE0) {
+		len = 2;
+		udecoded = b & 0x1F;
+	} else if (b < 0xF0) {
+		len = 3;
+		udecoded = b & 0x0F;
+	} else {
+		len = 4;
+		udecoded = b & 0x07;
+	}
+
+	for (i = 1; i < len; ++i) {
+		if (i == clen)
+			return 0;
+		if ((c[i] & 0xC0) != 0x80) {
+			*u = UTF_INVALID;
+			return i;
+		}
+		udecoded = (udecoded << 6) | (c[i] & 0x3F);
+	}
+	*u = (!BETWEEN(udecoded, utfmin[len], utfmax[len]) || BETWEEN(udecoded, 0xD800, 0xDFFF))
+	        ? UTF_INVALID : udecoded;
+
+	return len;
+}
+
+static int
+utf8decodebuf_scalar(const char *s, int len, Rune *u, uchar *sz, int siz)
+{
+	int i = 0, n = 0, k;
+
+	while (i < len && n < siz) {
+		if (!(k = utf8decodeseq(s + i, len - i, &u[n])))
+			break;
+		sz[n++] = k;
+		i += k;
+	}
+
+	return n;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse2")))
+static int
+utf8decodebuf_sse2(const char *s, int len, Rune *u, uchar *sz, int siz)
+{
+	const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi8(1);
+	__m128i v, lo, hi;
+	int i = 0, n = 0, k, mask;
+
+	while (i < len && n < siz) {
+		if (len - i >= 16 && siz - n >= 16) {
+			v = _mm_loadu_si128((const __m128i *)(s + i));
+			if (!(mask = _mm_movemask_epi8(v))) {
+				/* 16 ASCII characters, zero extend them to runes */
+				lo = _mm_unpacklo_epi8(v, zero);
+				hi = _mm_unpackhi_epi8(v, zero);
+				_mm_storeu_si128((__m128i *)(u + n), _mm_unpacklo_epi16(lo, zero));
+				_mm_storeu_si128((__m128i *)(u + n + 4), _mm_unpackhi_epi16(lo, zero));
+				_mm_storeu_si128((__m128i *)(u + n + 8), _mm_unpacklo_epi16(hi, zero));
+				_mm_storeu_si128((__m128i *)(u + n + 12), _mm_unpackhi_epi16(hi, zero));
+				_mm_storeu_si128((__m128i *)(sz + n), one);
+				i += 16;
+				n += 16;
+				continue;
+			}
+			/* copy the ASCII prefix leading up to the first multibyte sequence */
+			for (k = __builtin_ctz(mask); k > 0; k--, i++, n++) {
+				u[n] = (uchar)s[i];
+				sz[n] = 1;
+			}
+		}
+		if (!(k = utf8decodeseq(s + i, len - i, &u[n])))
+			break;
+		sz[n++] = k;
+		i += k;
+	}
+
+	return n;
+}
+
+__attribute__((target("avx2")))
+static int
+utf8decodebuf_avx2(const char *s, int len, Rune *u, uchar *sz, int siz)
+{
+	const __m256i one = _mm256_set1_epi8(1);
+	__m256i v;
+	int i = 0, n = 0, k, mask;
+
+	while (i < len && n < siz) {
+		if (len - i >= 32 && siz - n >= 32) {
+			v = _mm256_loadu_si256((const __m256i *)(s + i));
+			if (!(mask = _mm256_movemask_epi8(v))) {
+				/* 32 ASCII characters, zero extend them to runes */
+				for (k = 0; k < 32; k += 8)
+					_mm256_storeu_si256((__m256i *)(u + n + k), _mm256_cvtepu8_epi32(
+						_mm_loadl_epi64((const __m128i *)(s + i + k))));
+				_mm256_storeu_si256((__m256i *)(sz + n), one);
+				i += 32;
+				n += 32;
+				continue;
+			}
+			/* copy the ASCII prefix leading up to the first multibyte sequence */
+			for (k = __builtin_ctz(mask); k > 0; k--, i++, n++) {
+				u[n] = (uchar)s[i];
+				sz[n] = 1;
+			}
+		}
+		if (!(k = utf8decodeseq(s + i, len - i, &u[n])))
+			break;
+		sz[n++] = k;
+		i += k;
+	}
+
+	return n;
+}
+#endif
+
+/*
+ * Decodes as much of the UTF-8 input as fits in siz runes, storing each rune
+ * in u and the number of bytes it was decoded from in sz. Decoding stops
+ * before a partial sequence at the end of the input, which is left for the
+ * next read to complete.
+ *
+ * Returns the number of runes decoded.
+ */
+int
+utf8decodebuf(const char *s, int len, Rune *u, uchar *sz, int siz)
+{
+	static int (*decode)(const char *, int, Rune *, uchar *, int) = NULL;
+
+	if (!decode) {
+		decode = utf8decodebuf_scalar;
+		#if defined(__x86_64__) || defined(__i386__)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			decode = utf8decodebuf_avx2;
+		else if (__builtin_cpu_supports("sse2"))
+			decode = utf8decodebuf_sse2;
+		#endif
+	}
+
+	return decode(s, len, u, sz, siz);
+}
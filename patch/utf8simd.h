@@ -0,0 +1,7 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#define UTF8_DECODE_SIZ 1024
+
+static int utf8decodebuf(const char *, int, Rune *, uchar *, int);
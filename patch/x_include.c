@@ -8,6 +8,9 @@
 #if BOXDRAW_PATCH
 #include "boxdraw.c"
 #endif
+#if COALESCE_RESIZE_PATCH
+#include "coalesceresize.c"
+#endif
 #if DRAG_AND_DROP_PATCH
 #include "drag-n-drop.c"
 #endif
@@ -47,9 +50,15 @@
 #if RIGHTCLICKTOPLUMB_PATCH
 #include "rightclicktoplumb_x.c"
 #endif
+#if SCROLL_BLIT_PATCH
+#include "scrollblit_x.c"
+#endif
 #if ST_EMBEDDER_PATCH
 #include "st_embedder_x.c"
 #endif
+#if STREAMING_PASTE_PATCH
+#include "streampaste_x.c"
+#endif
 #if XRESOURCES_PATCH
 #include "xresources.c"
 #endif
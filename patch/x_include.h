@@ -8,6 +8,9 @@
 #if BOXDRAW_PATCH
 #include "boxdraw.h"
 #endif
+#if COALESCE_RESIZE_PATCH
+#include "coalesceresize.h"
+#endif
 #if DRAG_AND_DROP_PATCH
 #include "drag-n-drop.h"
 #endif
@@ -44,6 +47,9 @@
 #if ST_EMBEDDER_PATCH
 #include "st_embedder_x.h"
 #endif
+#if STREAMING_PASTE_PATCH
+#include "streampaste_x.h"
+#endif
 #if XRESOURCES_PATCH
 #include "xresources.h"
 #endif
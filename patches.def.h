@@ -46,6 +46,14 @@
  */
 #define ANYSIZE_SIMPLE_PATCH 0
 
+/* This patch adds a fast path for printable ASCII text. Rather than passing every character
+ * through tputc(), runs of printable ASCII that fit before the right margin are written
+ * directly into the current line with the cursor, dirty and wrap state updated once per run.
+ * Control characters, escape sequences and the right margin are still handled by tputc().
+ * This mainly speeds up plain output such as build logs and cat'ing large text files.
+ */
+#define ASCII_FASTPATH_PATCH 0
+
 /* Draws a background image in farbfeld format in place of the defaultbg color allowing for pseudo
  * transparency.
  * https://st.suckless.org/patches/background_image/
@@ -58,6 +66,13 @@
  */
 #define BACKGROUND_IMAGE_RELOAD_PATCH 0
 
+/* This patch adds a headless benchmark mode, st -B file, that feeds the given file (or stdin
+ * if "-") through the terminal emulation in the same chunk sizes as when reading from the shell
+ * and prints the throughput in MB/s, runes/s, escape sequences/s and scroll operations/s.
+ * Nothing is drawn and no X display is needed. Sixel images are not supported in this mode.
+ */
+#define BENCHMARK_PATCH 0
+
 /* This patch allows the use of a blinking cursor.
  * Only cursor styles 0, 1, 3, 5, and 7 blink. Set cursorstyle accordingly.
  * Cursor styles are defined here:
@@ -83,6 +98,13 @@
  */
 #define CLIPBOARD_PATCH 0
 
+/* By default every ConfigureNotify resizes the terminal, which reflows the text and sends
+ * a SIGWINCH to the shell. During an interactive drag that happens dozens of times per
+ * second. This patch keeps the old contents on display while the window is being resized
+ * and resizes the terminal once, after the window size has not changed for resizedelay ms.
+ */
+#define COALESCE_RESIZE_PATCH 0
+
 /* This patch allows st to be resized without cutting off text when the terminal window is
  * made larger again. Text does not wrap when the terminal window is made smaller, you may
  * also want to have a look at the reflow patch.
@@ -91,6 +113,23 @@
  */
 #define COLUMNS_PATCH 0
 
+/* This patch stores the lines in the scrollback history as the character plus an index into a
+ * table of the attributes (colors, mode and underline style) in use, rather than as full glyphs.
+ * This halves the memory used by the history, or quarters it with the undercurl patch. Lines are
+ * turned back into glyphs as they are read, through a small cache.
+ *
+ * This patch depends on REFLOW_PATCH being enabled.
+ */
+#define COMPACT_GLYPH_PATCH 0
+
+/* This patch compresses the lines in the scrollback history further, storing the attributes as
+ * runs and the characters as UTF-8 text while leaving out the cleared cells at the end of the line.
+ * Empty lines take up no memory at all. Lines are decompressed as they are read.
+ *
+ * This patch depends on REFLOW_PATCH and COMPACT_GLYPH_PATCH being enabled.
+ */
+#define COMPRESSED_HISTORY_PATCH 0
+
 /* Select and copy the last URL displayed with Mod+l. Multiple invocations cycle through the
  * available URLs.
  * https://st.suckless.org/patches/copyurl/
@@ -109,6 +148,17 @@
  */
 #define CSI_22_23_PATCH 0
 
+/* This patch replaces the chain of term.esc flag tests in tputc() with a table driven state
+ * machine, where what to do with each byte is looked up by the parser state and the class of
+ * the byte. The state is derived from the term.esc flags, so the DCS handling of the sixel patch
+ * and the sync patch keep working as they are.
+ * CSI parameters are also accumulated as the bytes arrive, rather than the whole sequence being
+ * scanned again with strtol() once the final byte has been received. Uncommon forms like colon
+ * separated or signed parameters are still handled by the original parser.
+ * This speeds up escape heavy output like ncurses applications and colourised logs.
+ */
+#define CSIPARSER_PATCH 0
+
 /* According to the specification (see link in BLINKING_CURSOR_PATCH) the "Set cursor style
  * (DECSCUSR), VT520." escape sequences define both values of 0 and 1 as a blinking block,
  * with 1 being the default.
@@ -129,6 +179,13 @@
  */
 #define DELKEY_PATCH 0
 
+/* This patch keeps track of which columns of a line have changed when text is written, erased,
+ * inserted or deleted, and only redraws those columns rather than the whole line. The redrawn
+ * span is widened so that wide glyphs, and with the ligatures or wide glyphs patches runs of
+ * cells with the same attributes, are always drawn as a whole.
+ */
+#define DIRTY_SPAN_PATCH 0
+
 /* This patch adds the option of disabling bold fonts globally.
  * https://st.suckless.org/patches/disable_bold_italic_fonts/
  */
@@ -154,6 +211,15 @@
  */
 #define DYNAMIC_CURSOR_COLOR_PATCH 0
 
+/* This patch makes the size of the scrollback history a runtime option, set with the -H command
+ * line option or the histsize resource, rather than the compile time HISTSIZE. The history grows
+ * in chunks as lines scroll off the screen, and its memory use can be capped with the -M option or
+ * the histmemory resource (in MiB).
+ *
+ * This patch depends on REFLOW_PATCH being enabled.
+ */
+#define DYNAMIC_HISTORY_PATCH 0
+
 /* This is a variant of the anysize patch that explicitly do not change the size increment hints,
  * i.e. only keeping the dynamic padding which is the main thing the anysize patch introduces.
  * In practice this means that the dynamic padding / anysize functionality only ever comes into
@@ -188,6 +254,11 @@
  */
 #define EXTERNALPIPEIN_PATCH 0
 
+/* This patch makes scrolling the whole screen up, as when tailing logs, move the start of the
+ * screen within a larger array of lines instead of rotating every line on the screen by one.
+ */
+#define FAST_SCROLL_PATCH 0
+
 /* This patch allows command line applications to use all the fancy key combinations
  * that are available to GUI applications.
  * https://st.suckless.org/patches/fix_keyboard_input/
@@ -221,6 +292,27 @@
  */
 #define HIDE_TERMINAL_CURSOR_PATCH 0
 
+/* By default a resize reflows the whole scrollback history before the window is drawn again.
+ * This patch only reflows the screen and the history scrolled into view right away; the rest of
+ * the history is reflowed newest first in small slices between frames, see reflowslice in
+ * config.def.h, or as soon as it is scrolled into view.
+ *
+ * This patch depends on REFLOW_PATCH being enabled.
+ */
+#define INCREMENTAL_REFLOW_PATCH 0
+
+/* By default searching in keyboard select mode reads and matches every cell of the history.
+ * This patch keeps a summary of the characters on each line as it is saved to the history, so
+ * that the search skips the lines that cannot hold a match. A search for a string that has the
+ * previous search string in it only looks at the lines the previous one found. Only the
+ * visible matches are highlighted right away; the rest of the history is highlighted in slices
+ * between frames, see searchslice in config.def.h. Summarizing the lines takes some of the
+ * throughput when a lot of output scrolls by.
+ *
+ * This patch depends on KEYBOARDSELECT_PATCH and REFLOW_PATCH being enabled.
+ */
+#define INDEXED_SEARCH_PATCH 0
+
 /* This patch adds a keybinding that lets you invert the current colorscheme of st.
  * This provides a simple way to temporarily switch to a light colorscheme if you use a dark
  * colorscheme or visa-versa.
@@ -241,6 +333,14 @@
  */
 #define KEYBOARDSELECT_PATCH 0
 
+/* This patch allocates the lines of the scrollback history when a line is first scrolled into
+ * them, and the alternate screen when it is first switched to, rather than all up front. Lines
+ * of the history that are not in use are freed rather than resized when the window is resized.
+ *
+ * This patch depends on REFLOW_PATCH being enabled.
+ */
+#define LAZY_ALLOC_PATCH 0
+
 /* This patch adds support for drawing ligatures using the Harfbuzz library to transform
  * original text of a single line to a list of glyphs with ligatures included.
  * This patch depends on the Harfbuzz library and headers to compile.
@@ -330,6 +430,17 @@
  */
 #define OSC7_PATCH 0
 
+/* This patch adds support for the OSC 8 escape sequence, which programs like ls, gcc and
+ * systemd use to turn text into hyperlinks. A hyperlink is opened the same way as a url
+ * with the openurlonclick patch. The uris are kept in a table that is shared by all the
+ * cells that link to them.
+ *
+ * This patch depends on OPENURLONCLICK_PATCH being enabled.
+ *
+ * https://gist.github.com/egmontkob/eb114294efbcd5adb1944c9f3cb5feda
+ */
+#define OSC8_PATCH 0
+
 /* This patch allows jumping between prompts by utilizing the OSC 133 escape sequence
  * emitted by shells. Must be used with either reflow or scrollback patch.
  *
@@ -344,6 +455,16 @@
  */
 #define REFLOW_PATCH 0
 
+/* The search string in keyboard select mode is matched literally. With this patch, pressing Tab
+ * while typing it toggles between that and reading it as a regular expression, e.g.
+ * error\[E[0-9]+\] or ([0-9]{1,3}\.){3}[0-9]{1,3}, that is compiled to a DFA and matched against
+ * whole lines, including the lines they wrap onto. The status bar then reads REGEX rather than
+ * SEARCH. Search strings that are not a valid regular expression are still matched literally.
+ *
+ * This patch depends on KEYBOARDSELECT_PATCH and REFLOW_PATCH being enabled.
+ */
+#define REGEX_SEARCH_PATCH 0
+
 /* This patch allows you to specify a border that is relative in size to the width of a cell
  * in the terminal.
  * https://st.suckless.org/patches/relativeborder/
@@ -373,6 +494,24 @@
  */
 #define SCROLLBACK_MOUSE_ALTSCREEN_PATCH 0
 
+/* This patch makes st move what is already on screen when lines scroll, be it output scrolling
+ * the screen or the scrollback being scrolled through, and only draw the lines that were scrolled
+ * in. Otherwise every line that moved is drawn again. This has no effect while there is a
+ * selection or sixel images on the screen, or with the background image patch.
+ */
+#define SCROLL_BLIT_PATCH 0
+
+/* This patch keeps the lines that fall off the end of the scrollback history in a memory mapped
+ * file in TMPDIR rather than throwing them away, so that the whole output of a long running
+ * session stays scrollable, searchable and selectable while memory use stays flat. The file is
+ * unlinked as soon as it has been created and is emptied when the scrollback is cleared.
+ * Spilled lines are not reflowed: after the window is made narrower, the lines spilled at the
+ * wider width are cut at the right edge.
+ *
+ * This patch depends on REFLOW_PATCH being enabled.
+ */
+#define SCROLLBACK_SPILL_PATCH 0
+
 /* This patch adds the two color-settings selectionfg and selectionbg to config.def.h.
  * Those define the fore- and background colors which are used when text on the screen is selected
  * with the mouse. This removes the default behaviour which would simply reverse the colors.
@@ -422,6 +561,26 @@
  */
 #define SPOILER_PATCH 0
 
+/* This patch makes pasting stream the selection to the shell one chunk at a time as it is read
+ * from the X server, rather than writing it out in one go. Large INCR transfers no longer have
+ * every chunk wrapped in its own pair of bracketed paste markers. Keystrokes and replies to
+ * queries that come up while a bracketed paste is being written are held back until after the
+ * end marker, so that they do not end up inside the paste. Pressing a key cuts the paste short, as
+ * do the selection owner going away and an INCR transfer that stalls for pastetimeout ms.
+ *
+ * Combined with the TTY_WRITEQUEUE_PATCH the next chunk is not requested until the shell has
+ * read the previous one, so pasting huge amounts of text neither uses a lot of memory nor
+ * freezes the terminal.
+ */
+#define STREAMING_PASTE_PATCH 0
+
+/* This patch passes OSC, DCS, APC and PM string sequences on a run of characters at a time and
+ * decodes the base64 payload of OSC 52 (set clipboard) sequences as it arrives, using SSSE3
+ * where available, instead of storing the whole sequence and decoding it at the end. Sequences
+ * longer than strmaxlen bytes (see config.h) are discarded rather than buffered.
+ */
+#define STRSTREAM_PATCH 0
+
 /* This patch changes the mouse shape to the global default when the running program subscribes
  * for mouse events, for instance, in programs like ranger and fzf. It emulates the behaviour
  * shown by vte terminals like termite.
@@ -449,6 +608,32 @@
  */
 #define THEMED_CURSOR_PATCH 0
 
+/* This patch reads the output of the shell into a large ring buffer (see ttyringsize in
+ * config.h) rather than a fixed 8 KiB buffer. The read size grows for as long as the shell keeps
+ * the reads full, which means fewer system calls and parsing passes when cat'ing large files.
+ */
+#define TTY_RINGBUFFER_PATCH 0
+
+/* This patch moves reading the output of the shell to a separate thread which fills a lock-free
+ * ring buffer (see ttyringsize in config.h) and wakes up the main loop through an eventfd, or a
+ * pipe on systems other than Linux. A burst of output then no longer holds up key presses and
+ * slow X round-trips no longer hold up reading from the shell. All terminal state is still only
+ * ever touched by the main thread.
+ *
+ * This replaces the TTY_RINGBUFFER_PATCH if both are enabled.
+ *
+ * You need to uncomment the corresponding line in config.mk to use the -lpthread library
+ * when including this patch (only needed for older versions of glibc).
+ */
+#define TTY_THREAD_PATCH 0
+
+/* This patch queues up input for the shell and writes it out without blocking from the main
+ * loop, rather than writing it 256 bytes at a time while everything else waits. Pasting large
+ * amounts of text or answering many queries then no longer freezes the terminal. st only waits
+ * for the shell once more than ttywritemax bytes (see config.h) are queued up.
+ */
+#define TTY_WRITEQUEUE_PATCH 0
+
 /* Adds support for special underlines.
  *
  * Example test command:
@@ -467,12 +652,29 @@
  */
 #define UNDERCURL_PATCH 0
 
+/* This patch replaces the use of wcwidth() with a lookup table, generated from the Unicode
+ * Character Database, for working out how many cells a character takes up. The result is then
+ * the same regardless of locale and libc version and it avoids a library call per character.
+ * The table is generated from Unicode 16.0.0. Run "make unicodewidth" with UCD set in
+ * config.mk to regenerate patch/unicodewidth_table.h.
+ */
+#define UNICODE_WIDTH_PATCH 0
+
 /* Allows mouse scroll without modifier keys for regardless of alt screen using the external
  * scroll program.
  * https://st.suckless.org/patches/universcroll/
  */
 #define UNIVERSCROLL_PATCH 0
 
+/* Keeps the urls found on each line of the screen until the line changes, so that the url under
+ * the mouse pointer does not have to be looked for again every time the pointer moves. The
+ * openurlonclick and copyurl patches use it, and copyurl can go on to the urls that have
+ * scrolled out of view.
+ *
+ * This patch depends on REFLOW_PATCH and on OPENURLONCLICK_PATCH or COPYURL_PATCH being enabled.
+ */
+#define URL_CACHE_PATCH 0
+
 /* Use XftFontMatch in place of FcFontMatch.
  *
  * XftFontMatch calls XftDefaultSubstitute which configures various match properties according
@@ -487,6 +689,13 @@
  */
 #define USE_XFTFONTMATCH_PATCH 0
 
+/* This patch decodes the UTF-8 input read from the terminal a whole buffer at a time rather than
+ * one character at a time. Runs of ASCII are decoded using SSE2 or AVX2 instructions, which one
+ * is used is decided at runtime based on what the CPU supports, falling back to plain C on other
+ * architectures. Invalid and partial sequences are handled the same as before.
+ */
+#define UTF8_SIMD_PATCH 0
+
 /* Vertically center lines in the space available if you have set a larger chscale in config.h
  * https://st.suckless.org/patches/vertcenter/
  */
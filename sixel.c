@@ -36,7 +36,9 @@ static sixel_color_t const sixel_default_color_table[] = {
 void
 scroll_images(int n) {
 	ImageList *im, *next;
-	#if SCROLLBACK_PATCH || REFLOW_PATCH
+	#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+	int top = tisaltscr() ? 0 : term.scr - MIN(term.histcap, (int)histsize);
+	#elif SCROLLBACK_PATCH || REFLOW_PATCH
 	int top = tisaltscr() ? 0 : term.scr - HISTSIZE;
 	#else
 	int top = 0;
@@ -145,6 +145,10 @@ typedef struct {
 	#if UNDERCURL_PATCH
 	int carg[ESC_ARG_SIZ][CAR_PER_ARG]; /* colon args */
 	#endif // UNDERCURL_PATCH
+	#if CSIPARSER_PATCH
+	int val;               /* arg being parsed */
+	uchar state;           /* parser state */
+	#endif // CSIPARSER_PATCH
 } CSIEscape;
 
 /* STR Escape sequence structs */
@@ -225,7 +229,6 @@ static inline void tsetsixelattr(Line line, int x1, int x2);
 #endif // SIXEL_PATCH
 static void tswapscreen(void);
 static void tsetmode(int, int, const int *, int);
-static int twrite(const char *, int, int);
 static void tcontrolcode(uchar );
 static void tdectest(char );
 static void tdefutf8(char);
@@ -938,6 +941,7 @@ ttynew(const char *line, char *cmd, const char *out, char **args)
 	return cmdfd;
 }
 
+#if !TTY_RINGBUFFER_PATCH && !TTY_THREAD_PATCH
 size_t
 ttyread(void)
 {
@@ -956,6 +960,10 @@ ttyread(void)
 	case 0:
 		exit(0);
 	case -1:
+		#if TTY_WRITEQUEUE_PATCH
+		if (errno == EAGAIN)
+			return 0;
+		#endif // TTY_WRITEQUEUE_PATCH
 		die("couldn't read from shell: %s\n", strerror(errno));
 	default:
 		#if SYNC_PATCH
@@ -971,6 +979,7 @@ ttyread(void)
 		return ret;
 	}
 }
+#endif // TTY_RINGBUFFER_PATCH
 
 void
 ttywrite(const char *s, size_t n, int may_echo)
@@ -983,6 +992,11 @@ ttywrite(const char *s, size_t n, int may_echo)
 	if (may_echo && IS_SET(MODE_ECHO))
 		twrite(s, n, 1);
 
+	#if STREAMING_PASTE_PATCH
+	if (ttypasteheld(s, n))
+		return;
+	#endif // STREAMING_PASTE_PATCH
+
 	if (!IS_SET(MODE_CRLF)) {
 		ttywriteraw(s, n);
 		return;
@@ -1003,12 +1017,19 @@ ttywrite(const char *s, size_t n, int may_echo)
 	}
 }
 
+#if !TTY_WRITEQUEUE_PATCH
 void
 ttywriteraw(const char *s, size_t n)
 {
 	fd_set wfd, rfd;
 	ssize_t r;
 	size_t lim = 256;
+	#if TTY_THREAD_PATCH
+	/* the output of the shell is read through the reader thread */
+	int rfdno = ttythread_readfd();
+	#else
+	int rfdno = cmdfd;
+	#endif // TTY_THREAD_PATCH
 
 	/*
 	 * Remember that we are using a pty, which might be a modem line.
@@ -1020,10 +1041,11 @@ ttywriteraw(const char *s, size_t n)
 		FD_ZERO(&wfd);
 		FD_ZERO(&rfd);
 		FD_SET(cmdfd, &wfd);
-		FD_SET(cmdfd, &rfd);
+		if (rfdno >= 0)
+			FD_SET(rfdno, &rfd);
 
 		/* Check if we can write. */
-		if (pselect(cmdfd+1, &rfd, &wfd, NULL, NULL, NULL) < 0) {
+		if (pselect(MAX(cmdfd, rfdno)+1, &rfd, &wfd, NULL, NULL, NULL) < 0) {
 			if (errno == EINTR)
 				continue;
 			die("select failed: %s\n", strerror(errno));
@@ -1042,8 +1064,10 @@ ttywriteraw(const char *s, size_t n)
 				 * This means the buffer is getting full
 				 * again. Empty it.
 				 */
+				#if !TTY_THREAD_PATCH
 				if (n < lim)
 					lim = ttyread();
+				#endif // TTY_THREAD_PATCH
 				n -= r;
 				s += r;
 			} else {
@@ -1051,14 +1075,20 @@ ttywriteraw(const char *s, size_t n)
 				break;
 			}
 		}
+		#if TTY_THREAD_PATCH
+		if (rfdno >= 0 && FD_ISSET(rfdno, &rfd))
+			ttythread_catchup();
+		#else
 		if (FD_ISSET(cmdfd, &rfd))
 			lim = ttyread();
+		#endif // TTY_THREAD_PATCH
 	}
 	return;
 
 write_error:
 	die("write error on tty: %s\n", strerror(errno));
 }
+#endif // TTY_WRITEQUEUE_PATCH
 
 void
 ttyresize(int tw, int th)
@@ -1156,6 +1186,10 @@ tfulldirt(void)
 	#else
 	tsetdirt(0, term.row-1);
 	#endif // REFLOW_PATCH
+	#if SCROLL_BLIT_PATCH
+	term.scrolln = 0;
+	scrollstale = 0;
+	#endif // SCROLL_BLIT_PATCH
 }
 
 void
@@ -1201,6 +1235,12 @@ treset(void)
 	term.histf = 0;
 	term.histi = 0;
 	term.scr = 0;
+	#if SCROLLBACK_SPILL_PATCH
+	spillclear();
+	#endif // SCROLLBACK_SPILL_PATCH
+	#if INCREMENTAL_REFLOW_PATCH
+	treflowdrop();
+	#endif // INCREMENTAL_REFLOW_PATCH
 	selremove();
 	#endif // REFLOW_PATCH
 
@@ -1243,11 +1283,15 @@ tnew(int col, int row)
 void
 tswapscreen(void)
 {
-	Line *tmp = term.line;
+	Line *tmp;
 	#if SIXEL_PATCH
 	ImageList *im = term.images;
 	#endif // SIXEL_PATCH
 
+	#if FAST_SCROLL_PATCH
+	tscrollringreset();
+	#endif // FAST_SCROLL_PATCH
+	tmp = term.line;
 	term.line = term.alt;
 	term.alt = tmp;
 	#if SIXEL_PATCH
@@ -1266,6 +1310,10 @@ tscrolldown(int orig, int n)
 	#if OPENURLONCLICK_PATCH
 	restoremousecursor();
 	#endif //OPENURLONCLICK_PATCH
+	#if BENCHMARK_PATCH
+	if (benchmode)
+		benchscrolls++;
+	#endif // BENCHMARK_PATCH
 
 	int i;
 	Line temp;
@@ -1282,12 +1330,22 @@ tscrolldown(int orig, int n)
 
 	LIMIT(n, 0, term.bot-orig+1);
 
+	#if !SCROLL_BLIT_PATCH
 	tsetdirt(orig, term.bot-n);
+	#endif // SCROLL_BLIT_PATCH
 	#if COLUMNS_PATCH
 	tclearregion(0, term.bot-n+1, term.maxcol-1, term.bot);
 	#else
 	tclearregion(0, term.bot-n+1, term.col-1, term.bot);
 	#endif // COLUMNS_PATCH
+	#if SCROLL_BLIT_PATCH && SCROLLBACK_PATCH
+	if (term.scr)
+		tsetdirt(orig, term.bot-n);
+	else
+		tscrollblit(orig, term.bot, -n);
+	#elif SCROLL_BLIT_PATCH
+	tscrollblit(orig, term.bot, -n);
+	#endif // SCROLL_BLIT_PATCH
 
 	for (i = term.bot; i >= orig+n; i--) {
 		temp = term.line[i];
@@ -1327,6 +1385,10 @@ tscrollup(int orig, int n)
 	#if OPENURLONCLICK_PATCH
 	restoremousecursor();
 	#endif //OPENURLONCLICK_PATCH
+	#if BENCHMARK_PATCH
+	if (benchmode)
+		benchscrolls++;
+	#endif // BENCHMARK_PATCH
 
 	int i;
 	Line temp;
@@ -1363,8 +1425,22 @@ tscrollup(int orig, int n)
 	#else
 	tclearregion(0, orig, term.col-1, orig+n-1);
 	#endif // COLUMNS_PATCH
+	#if SCROLL_BLIT_PATCH && SCROLLBACK_PATCH
+	if (term.scr)
+		tsetdirt(orig+n, term.bot);
+	else
+		tscrollblit(orig, term.bot, n);
+	#elif SCROLL_BLIT_PATCH
+	tscrollblit(orig, term.bot, n);
+	#else
 	tsetdirt(orig+n, term.bot);
+	#endif // SCROLL_BLIT_PATCH
 
+	#if FAST_SCROLL_PATCH
+	if (orig == 0 && term.bot == term.row-1)
+		tscrollring(n);
+	else
+	#endif // FAST_SCROLL_PATCH
 	for (i = orig; i <= term.bot-n; i++) {
 		temp = term.line[i];
 		term.line[i] = term.line[i+n];
@@ -1579,7 +1655,12 @@ tsetchar(Rune u, const Glyph *attr, int x, int y)
 		term.line[y][x-1].mode &= ~ATTR_WIDE;
 	}
 
+	#if DIRTY_SPAN_PATCH
+	tsetdirtspan(y, (term.line[y][x].mode & ATTR_WDUMMY) ? x-1 : x,
+		(term.line[y][x].mode & ATTR_WIDE) ? x+2 : x+1);
+	#else
 	term.dirty[y] = 1;
+	#endif // DIRTY_SPAN_PATCH
 	term.line[y][x] = *attr;
 	term.line[y][x].u = u;
 	#if REFLOW_PATCH
@@ -1615,7 +1696,11 @@ tclearregion(int x1, int y1, int x2, int y2)
 	LIMIT(y2, 0, term.row-1);
 
 	for (y = y1; y <= y2; y++) {
+		#if DIRTY_SPAN_PATCH
+		tsetdirtspan(y, x1, x2+1);
+		#else
 		term.dirty[y] = 1;
+		#endif // DIRTY_SPAN_PATCH
 		for (x = x1; x <= x2; x++) {
 			gp = &term.line[y][x];
 			if (selected(x, y))
@@ -1624,6 +1709,9 @@ tclearregion(int x1, int y1, int x2, int y2)
 			gp->bg = term.c.attr.bg;
 			gp->mode = 0;
 			gp->u = ' ';
+			#if OSC8_PATCH
+			gp->link = 0;
+			#endif // OSC8_PATCH
 		}
 	}
 }
@@ -1644,6 +1732,9 @@ tdeletechar(int n)
 	line = term.line[term.c.y];
 
 	memmove(&line[dst], &line[src], size * sizeof(Glyph));
+	#if DIRTY_SPAN_PATCH
+	tsetdirtspan(term.c.y, dst, term.col);
+	#endif // DIRTY_SPAN_PATCH
 	tclearregion(term.col-n, term.c.y, term.col-1, term.c.y);
 }
 #endif // REFLOW_PATCH
@@ -1663,6 +1754,9 @@ tinsertblank(int n)
 	line = term.line[term.c.y];
 
 	memmove(&line[dst], &line[src], size * sizeof(Glyph));
+	#if DIRTY_SPAN_PATCH
+	tsetdirtspan(term.c.y, src, term.col);
+	#endif // DIRTY_SPAN_PATCH
 	tclearregion(src, term.c.y, dst - 1, term.c.y);
 }
 #endif // REFLOW_PATCH
@@ -1684,6 +1778,9 @@ tdeleteimages(void)
 		next = im->next;
 		delete_image(im);
 	}
+	#if REFLOW_PATCH && INCREMENTAL_REFLOW_PATCH
+	treflowdropimages();
+	#endif // INCREMENTAL_REFLOW_PATCH
 }
 #endif // SIXEL_PATCH
 
@@ -2112,6 +2209,11 @@ csihandle(void)
 	int maxcol = term.col;
 	#endif // COLUMNS_PATCH
 
+	#if BENCHMARK_PATCH
+	if (benchmode)
+		benchescapes++;
+	#endif // BENCHMARK_PATCH
+
 	switch (csiescseq.mode[0]) {
 	default:
 	unknown:
@@ -2291,6 +2393,12 @@ csihandle(void)
 			term.scr = 0;
 			term.histi = 0;
 			term.histf = 0;
+			#if SCROLLBACK_SPILL_PATCH
+			spillclear();
+			#endif // SCROLLBACK_SPILL_PATCH
+			#if INCREMENTAL_REFLOW_PATCH
+			treflowdrop();
+			#endif // INCREMENTAL_REFLOW_PATCH
 			#if SIXEL_PATCH
 			for (im = term.images; im; im = next) {
 				next = im->next;
@@ -2596,7 +2704,12 @@ csidump(void)
 void
 csireset(void)
 {
+	#if CSIPARSER_PATCH
+	/* the raw string is never read past csiescseq.len */
+	memset(&csiescseq.len, 0, sizeof(csiescseq) - offsetof(CSIEscape, len));
+	#else
 	memset(&csiescseq, 0, sizeof(csiescseq));
+	#endif // CSIPARSER_PATCH
 }
 
 void
@@ -2646,7 +2759,16 @@ strhandle(void)
 	#endif // SCROLLBACK_PATCH
 	#endif // SIXEL_PATCH
 
+	#if BENCHMARK_PATCH
+	if (benchmode)
+		benchescapes++;
+	#endif // BENCHMARK_PATCH
+
 	term.esc &= ~(ESC_STR_END|ESC_STR);
+	#if STRSTREAM_PATCH
+	if (strstreamaborted())
+		return;
+	#endif // STRSTREAM_PATCH
 	strparse();
 	par = (narg = strescseq.narg) ? atoi(strescseq.args[0]) : 0;
 
@@ -2677,7 +2799,12 @@ strhandle(void)
 			return;
 		case 52: /* manipulate selection data */
 			if (narg > 2 && allowwindowops) {
+				#if STRSTREAM_PATCH
+				if (!(dec = strstreamosc52()))
+					dec = base64dec(strescseq.args[2]);
+				#else
 				dec = base64dec(strescseq.args[2]);
+				#endif // STRSTREAM_PATCH
 				if (dec) {
 					xsetsel(dec);
 					xclipcopy();
@@ -2692,6 +2819,9 @@ strhandle(void)
 			return;
 		#endif // OSC7_PATCH
 		case 8: /* Clear Hyperlinks */
+			#if OSC8_PATCH
+			osc8(narg > 1 ? strescseq.args[1] : "", narg > 2 ? strescseq.args[2] : "");
+			#endif // OSC8_PATCH
 			return;
 		case 10: /* set dynamic VT100 text foreground color */
 		case 11: /* set dynamic VT100 text background color */
@@ -2919,6 +3049,20 @@ strparse(void)
 		return;
 	}
 
+	#if OSC8_PATCH
+	/* preserve semicolons in OSC 8 hyperlink uris */
+	if (strescseq.type == ']' && p[0] == '8' && p[1] == ';') {
+		strescseq.args[strescseq.narg++] = p;
+		strescseq.args[strescseq.narg++] = p + 2;
+		p[1] = '\0';
+		if ((p = strchr(p + 2, ';'))) {
+			*p = '\0';
+			strescseq.args[strescseq.narg++] = p + 1;
+		}
+		return;
+	}
+	#endif // OSC8_PATCH
+
 	while (strescseq.narg < STR_ARG_SIZ) {
 		strescseq.args[strescseq.narg++] = p;
 		while ((c = *p) != ';' && c != '\0')
@@ -2963,6 +3107,9 @@ strreset(void)
 		.buf = xrealloc(strescseq.buf, STR_BUF_SIZ),
 		.siz = STR_BUF_SIZ,
 	};
+	#if STRSTREAM_PATCH
+	strstreamreset();
+	#endif // STRSTREAM_PATCH
 }
 
 void
@@ -3389,13 +3536,22 @@ tputc(Rune u)
 		width = len = 1;
 	} else {
 		len = utf8encode(u, c);
+		#if UNICODE_WIDTH_PATCH
+		if (!control)
+			width = unicodewidth(u);
+		#else
 		if (!control && (width = wcwidth(u)) == -1)
 			width = 1;
+		#endif // UNICODE_WIDTH_PATCH
 	}
 
 	if (IS_SET(MODE_PRINT))
 		tprinter(c, len);
 
+	#if CSIPARSER_PATCH
+	if (vtputc(u, c, len))
+		return;
+	#else
 	/*
 	 * STR sequence must be checked before anything else
 	 * because it uses all following characters until it
@@ -3419,6 +3575,10 @@ tputc(Rune u)
 			goto check_control_code;
 		#endif // SIXEL_PATCH
 
+		#if STRSTREAM_PATCH
+		strput(c, len);
+		return;
+		#else
 		if (strescseq.len+len >= strescseq.siz) {
 			/*
 			 * Here is a bug in terminals. If the user never sends
@@ -3442,6 +3602,7 @@ tputc(Rune u)
 		memmove(&strescseq.buf[strescseq.len], c, len);
 		strescseq.len += len;
 		return;
+		#endif // STRSTREAM_PATCH
 	}
 
 check_control_code:
@@ -3500,12 +3661,18 @@ check_control_code:
 			/* sequence already finished */
 		}
 		term.esc = 0;
+		#if BENCHMARK_PATCH
+		if (benchmode)
+			benchescapes++;
+		#endif // BENCHMARK_PATCH
+
 		/*
 		 * All characters which form part of a sequence are not
 		 * printed
 		 */
 		return;
 	}
+	#endif // CSIPARSER_PATCH
 
 	#if REFLOW_PATCH
 	/* selected() takes relative coordinates */
@@ -3526,6 +3693,9 @@ check_control_code:
 	if (IS_SET(MODE_INSERT) && term.c.x+width < term.col) {
 		memmove(gp+width, gp, (term.col - term.c.x - width) * sizeof(Glyph));
 		gp->mode &= ~ATTR_WIDE;
+		#if DIRTY_SPAN_PATCH
+		tsetdirtspan(term.c.y, term.c.x, term.col);
+		#endif // DIRTY_SPAN_PATCH
 	}
 
 	if (term.c.x+width > term.col) {
@@ -3548,6 +3718,9 @@ check_control_code:
 			if (gp[1].mode == ATTR_WIDE && term.c.x+2 < term.col) {
 				gp[2].u = ' ';
 				gp[2].mode &= ~ATTR_WDUMMY;
+				#if DIRTY_SPAN_PATCH
+				tsetdirtspan(term.c.y, term.c.x, term.c.x+3);
+				#endif // DIRTY_SPAN_PATCH
 			}
 			gp[1].u = '\0';
 			gp[1].mode = ATTR_WDUMMY;
@@ -3569,16 +3742,31 @@ twrite(const char *buf, int buflen, int show_ctrl)
 	int charsize;
 	Rune u;
 	int n;
+	#if ASCII_FASTPATH_PATCH || STRSTREAM_PATCH
+	int len;
+	#endif // ASCII_FASTPATH_PATCH | STRSTREAM_PATCH
+	#if UTF8_SIMD_PATCH
+	Rune runes[UTF8_DECODE_SIZ];
+	uchar sizes[UTF8_DECODE_SIZ];
+	int ri = 0, rn = 0;
+	#endif // UTF8_SIMD_PATCH
 
 	#if SYNC_PATCH
 	int su0 = su;
 	twrite_aborted = 0;
 	#endif // SYNC_PATCH
+	#if SCROLL_BLIT_PATCH && (SCROLLBACK_PATCH || REFLOW_PATCH)
+	if (term.scr)
+		scrollstale = 1;
+	#endif // SCROLL_BLIT_PATCH
 
 	for (n = 0; n < buflen; n += charsize) {
 		#if SIXEL_PATCH
 		if (IS_SET(MODE_SIXEL) && sixel_st.state != PS_ESC) {
 			charsize = sixel_parser_parse(&sixel_st, (const unsigned char*)buf + n, buflen - n);
+			#if UTF8_SIMD_PATCH
+			ri = rn = 0;
+			#endif // UTF8_SIMD_PATCH
 			continue;
 		} else if (IS_SET(MODE_UTF8))
 		#else
@@ -3586,10 +3774,24 @@ twrite(const char *buf, int buflen, int show_ctrl)
 		#endif // SIXEL_PATCH
 		{
 			/* process a complete utf8 char */
+			#if UTF8_SIMD_PATCH
+			if (ri == rn) {
+				ri = 0;
+				rn = utf8decodebuf(buf + n, buflen - n, runes, sizes, LEN(runes));
+				if (rn == 0)
+					break;
+			}
+			u = runes[ri];
+			charsize = sizes[ri++];
+			#else
 			charsize = utf8decode(buf + n, &u, buflen - n);
 			if (charsize == 0)
 				break;
+			#endif // UTF8_SIMD_PATCH
 		} else {
+			#if UTF8_SIMD_PATCH
+			ri = rn = 0;
+			#endif // UTF8_SIMD_PATCH
 			u = buf[n] & 0xFF;
 			charsize = 1;
 		}
@@ -3599,6 +3801,10 @@ twrite(const char *buf, int buflen, int show_ctrl)
 			break;  // ESU - allow rendering before a new BSU
 		}
 		#endif // SYNC_PATCH
+		#if BENCHMARK_PATCH
+		if (benchmode)
+			benchrunes++;
+		#endif // BENCHMARK_PATCH
 		if (show_ctrl && ISCONTROL(u)) {
 			if (u & 0x80) {
 				u &= 0x7f;
@@ -3609,6 +3815,28 @@ twrite(const char *buf, int buflen, int show_ctrl)
 				tputc('^');
 			}
 		}
+		#if STRSTREAM_PATCH
+		if (BETWEEN(u, 0x20, 0x7e) && (len = strputrun(buf + n, buflen - n))) {
+			charsize = len;
+			#if UTF8_SIMD_PATCH
+			/* the run was decoded one rune per byte, skip past it */
+			if ((ri += len - 1) > rn)
+				ri = rn = 0;
+			#endif // UTF8_SIMD_PATCH
+			continue;
+		}
+		#endif // STRSTREAM_PATCH
+		#if ASCII_FASTPATH_PATCH
+		if (BETWEEN(u, 0x20, 0x7e) && (len = tputascii(buf + n, buflen - n))) {
+			charsize = len;
+			#if UTF8_SIMD_PATCH
+			/* the run was decoded one rune per byte, skip past it */
+			if ((ri += len - 1) > rn)
+				ri = rn = 0;
+			#endif // UTF8_SIMD_PATCH
+			continue;
+		}
+		#endif // ASCII_FASTPATH_PATCH
 		tputc(u);
 	}
 	return n;
@@ -3670,9 +3898,16 @@ tresize(int col, int row)
 	}
 
 	/* resize to new height */
+	#if FAST_SCROLL_PATCH
+	tscrollringreset();
+	#endif // FAST_SCROLL_PATCH
 	term.line = xrealloc(term.line, row * sizeof(Line));
 	term.alt  = xrealloc(term.alt,  row * sizeof(Line));
 	term.dirty = xrealloc(term.dirty, row * sizeof(*term.dirty));
+	#if DIRTY_SPAN_PATCH
+	term.dirtyminx = xrealloc(term.dirtyminx, row * sizeof(*term.dirtyminx));
+	term.dirtymaxx = xrealloc(term.dirtymaxx, row * sizeof(*term.dirtymaxx));
+	#endif // DIRTY_SPAN_PATCH
 	term.tabs = xrealloc(term.tabs, col * sizeof(*term.tabs));
 
 	#if SCROLLBACK_PATCH
@@ -3790,17 +4025,39 @@ void
 drawregion(int x1, int y1, int x2, int y2)
 {
 	int y;
+	#if DIRTY_SPAN_PATCH
+	int sx1, sx2;
+	Line line;
+	#endif // DIRTY_SPAN_PATCH
+
+	#if REFLOW_PATCH && URL_CACHE_PATCH
+	urlcacheupdate();
+	#endif // URL_CACHE_PATCH
 
 	for (y = y1; y < y2; y++) {
 		if (!term.dirty[y])
 			continue;
 
+		#if DIRTY_SPAN_PATCH
+		#if SCROLLBACK_PATCH || REFLOW_PATCH
+		line = TLINE(y);
+		#else
+		line = term.line[y];
+		#endif // SCROLLBACK_PATCH
+		sx1 = x1, sx2 = x2;
+		if (term.dirty[y] == DIRTY_SPAN)
+			tdirtspan(line, y, &sx1, &sx2);
+		term.dirty[y] = 0;
+		if (sx1 < sx2)
+			xdrawline(line, sx1, y, sx2);
+		#else
 		term.dirty[y] = 0;
 		#if SCROLLBACK_PATCH || REFLOW_PATCH
 		xdrawline(TLINE(y), x1, y, x2);
 		#else
 		xdrawline(term.line[y], x1, y, x2);
 		#endif // SCROLLBACK_PATCH
+		#endif // DIRTY_SPAN_PATCH
 	}
 }
 
@@ -3822,6 +4079,9 @@ draw(void)
 	if (term.line[term.c.y][cx].mode & ATTR_WDUMMY)
 		cx--;
 
+	#if SCROLL_BLIT_PATCH
+	tscrollblitdraw();
+	#endif // SCROLL_BLIT_PATCH
 	drawregion(0, 0, term.col, term.row);
 
 	#if KEYBOARDSELECT_PATCH && REFLOW_PATCH
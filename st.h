@@ -36,6 +36,9 @@
 #if SCROLLBACK_PATCH || REFLOW_PATCH
 #define HISTSIZE      2000
 #endif // SCROLLBACK_PATCH | REFLOW_PATCH
+#if DYNAMIC_HISTORY_PATCH
+#define HISTCHUNK     256
+#endif // DYNAMIC_HISTORY_PATCH
 
 #if DRAG_AND_DROP_PATCH
 #define HEX_TO_INT(c)		((c) >= '0' && (c) <= '9' ? (c) - '0' : \
@@ -149,6 +152,9 @@ typedef struct {
 	uint32_t mode;    /* attribute flags */
 	uint32_t fg;      /* foreground  */
 	uint32_t bg;      /* background  */
+	#if OSC8_PATCH
+	uint32_t link;    /* hyperlink */
+	#endif // OSC8_PATCH
 	#if UNDERCURL_PATCH
 	int ustyle;	      /* underline style */
 	int ucolor[3];    /* underline color */
@@ -157,6 +163,27 @@ typedef struct {
 
 typedef Glyph *Line;
 
+#if COMPACT_GLYPH_PATCH
+typedef struct {
+	Rune u;           /* character code */
+	uint32_t attr;    /* index into the attribute table */
+} Cell;
+#endif // COMPACT_GLYPH_PATCH
+
+#if COMPRESSED_HISTORY_PATCH
+typedef struct HistLine HistLine;
+#endif // COMPRESSED_HISTORY_PATCH
+
+#if REFLOW_PATCH
+#if COMPACT_GLYPH_PATCH && COMPRESSED_HISTORY_PATCH
+typedef HistLine *HistEntry;
+#elif COMPACT_GLYPH_PATCH
+typedef Cell *HistEntry;
+#else
+typedef Line HistEntry;
+#endif // COMPACT_GLYPH_PATCH
+#endif // REFLOW_PATCH
+
 #if LIGATURES_PATCH
 typedef struct {
 	int ox;
@@ -182,10 +209,26 @@ typedef struct {
 	#endif // COLUMNS_PATCH
 	Line *line;   /* screen */
 	Line *alt;    /* alternate screen */
+	#if FAST_SCROLL_PATCH
+	int linebase; /* offset of line into its allocation */
+	int linecap;  /* number of lines allocated for line */
+	#endif // FAST_SCROLL_PATCH
 	#if REFLOW_PATCH
-	Line hist[HISTSIZE]; /* history buffer */
+	#if DYNAMIC_HISTORY_PATCH
+	HistEntry **hist;    /* history buffer, in chunks of HISTCHUNK lines */
+	int histcap;         /* nb history lines allocated */
+	#else
+	HistEntry hist[HISTSIZE]; /* history buffer */
+	#endif // DYNAMIC_HISTORY_PATCH
 	int histi;           /* history index */
 	int histf;           /* nb history available */
+	#if SCROLLBACK_SPILL_PATCH
+	int histspill;       /* nb history lines spilled to disk */
+	#endif // SCROLLBACK_SPILL_PATCH
+	#if KEYBOARDSELECT_PATCH && INDEXED_SEARCH_PATCH
+	uint histseq;        /* nb lines ever saved to history */
+	uint histgen;        /* changed whenever history lines are rewritten */
+	#endif // INDEXED_SEARCH_PATCH
 	int scr;             /* scroll back */
 	int wrapcwidth[2];   /* used in updating WRAPNEXT when resizing */
 	#elif SCROLLBACK_PATCH
@@ -195,6 +238,15 @@ typedef struct {
 	int scr;      /* scroll back */
 	#endif // SCROLLBACK_PATCH | REFLOW_PATCH
 	int *dirty;   /* dirtyness of lines */
+	#if DIRTY_SPAN_PATCH
+	int *dirtyminx; /* first dirty column of DIRTY_SPAN lines */
+	int *dirtymaxx; /* column after the last dirty one */
+	#endif // DIRTY_SPAN_PATCH
+	#if SCROLL_BLIT_PATCH
+	int scrolln;    /* lines scrolled up since the last draw */
+	int scrolltop;  /* top of the scrolled region */
+	int scrollbot;  /* bottom of the scrolled region */
+	#endif // SCROLL_BLIT_PATCH
 	TCursor c;    /* cursor */
 	int ocx;      /* old cursor col */
 	int ocy;      /* old cursor row */
@@ -372,11 +424,27 @@ int tisaltscr(void);
 void tnew(int, int);
 void tresize(int, int);
 void tsetdirtattr(int);
+int twrite(const char *, int, int);
 void ttyhangup(void);
 int ttynew(const char *, char *, const char *, char **);
 size_t ttyread(void);
+#if TTY_THREAD_PATCH
+int ttythread(void);
+#endif // TTY_THREAD_PATCH
+#if TTY_WRITEQUEUE_PATCH
+void ttyflush(void);
+size_t ttywritepending(void);
+#endif // TTY_WRITEQUEUE_PATCH
 void ttyresize(int, int);
 void ttywrite(const char *, size_t, int);
+#if STREAMING_PASTE_PATCH
+void ttypaste(const char *, size_t, int);
+void ttypastehold(int);
+int ttypasteheld(const char *, size_t);
+#endif // STREAMING_PASTE_PATCH
+#if BENCHMARK_PATCH
+int benchmark(const char *, int, int);
+#endif // BENCHMARK_PATCH
 
 void resettitle(void);
 
@@ -423,6 +491,19 @@ extern unsigned int tabspaces;
 extern unsigned int defaultfg;
 extern unsigned int defaultbg;
 extern unsigned int defaultcs;
+#if TTY_RINGBUFFER_PATCH || TTY_THREAD_PATCH
+extern unsigned int ttyringsize;
+#endif // TTY_RINGBUFFER_PATCH
+#if STRSTREAM_PATCH
+extern unsigned int strmaxlen;
+#endif // STRSTREAM_PATCH
+#if TTY_WRITEQUEUE_PATCH
+extern unsigned int ttywritemax;
+#endif // TTY_WRITEQUEUE_PATCH
+#if DYNAMIC_HISTORY_PATCH
+extern unsigned int histsize;
+extern unsigned int histmemory;
+#endif // DYNAMIC_HISTORY_PATCH
 #if EXTERNALPIPE_PATCH
 extern int extpipeactive;
 #endif // EXTERNALPIPE_PATCH
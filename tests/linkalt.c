@@ -0,0 +1,38 @@
+/*
+ * Leaves a link on the main screen while enough links are made on the
+ * alternate screen for the unused ones to be freed.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "../st.h"
+#include "../win.h"
+#if OSC8_PATCH
+#include "../patch/osc8.h"
+#endif // OSC8_PATCH
+
+int
+main(void)
+{
+	#if OSC8_PATCH
+	char buf[64], *uri;
+	int i, n;
+
+	tnew(80, 24);
+	n = snprintf(buf, sizeof(buf), "\033]8;;http://main\033\\X\033]8;;\033\\\r\n");
+	twrite(buf, n, 0);
+	twrite("\033[?1049h", 8, 0);
+	for (i = 0; i < 600; i++) {
+		n = snprintf(buf, sizeof(buf), "\033]8;;http://alt/%d\033\\Y\033]8;;\033\\\r\n", i);
+		twrite(buf, n, 0);
+	}
+	twrite("\033[?1049l", 8, 0);
+
+	uri = linkuri(term.line[0][0].link);
+	if (!uri || strcmp(uri, "http://main")) {
+		fprintf(stderr, "linkalt: the link on the main screen is gone\n");
+		return 1;
+	}
+	#endif // OSC8_PATCH
+	return 0;
+}
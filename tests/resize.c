@@ -0,0 +1,33 @@
+/*
+ * Shrinks the screen with the cursor near the bottom, which scrolls the
+ * screen up before term.line is reallocated.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "../st.h"
+#include "../win.h"
+
+int
+main(void)
+{
+	char buf[32];
+	int i, n;
+
+	tnew(80, 24);
+	for (i = 0; i < 30; i++) {
+		n = snprintf(buf, sizeof(buf), "line %d\r\n", i);
+		twrite(buf, n, 0);
+	}
+	tresize(80, 10);
+
+	if (term.row != 10 || term.c.y != 9) {
+		fprintf(stderr, "resize: cursor on row %d of %d\n", term.c.y, term.row);
+		return 1;
+	}
+	if (term.line[8][5].u != '2' || term.line[8][6].u != '9') {
+		fprintf(stderr, "resize: line 29 is not on row 8\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * Searches in keyboard select mode after more lines than the history ring
+ * holds have been written, and counts the highlights on every line, the
+ * spilled ones included.
+ */
+#include <stdio.h>
+
+#include "../st.h"
+#include "../win.h"
+#if KEYBOARDSELECT_PATCH && REFLOW_PATCH && SCROLLBACK_SPILL_PATCH
+#include "../patch/reflow.h"
+#if COMPACT_GLYPH_PATCH
+#include "../patch/compactglyph.h"
+#endif // COMPACT_GLYPH_PATCH
+#include "../patch/spill.h"
+#include "../patch/keyboardselect_reflow_st.h"
+#if INDEXED_SEARCH_PATCH
+#include "../patch/indexedsearch.h"
+#endif // INDEXED_SEARCH_PATCH
+#endif // KEYBOARDSELECT_PATCH && REFLOW_PATCH && SCROLLBACK_SPILL_PATCH
+
+int
+main(void)
+{
+	#if KEYBOARDSELECT_PATCH && REFLOW_PATCH && SCROLLBACK_SPILL_PATCH
+	char buf[64];
+	int i, n, x, y, lines = 3 * HISTSIZE;
+	Line line;
+
+	tnew(80, 24);
+	for (i = 0; i < lines; i++) {
+		n = snprintf(buf, sizeof(buf), "line %d x\r\n", i);
+		twrite(buf, n, 0);
+	}
+	if (!term.histspill) {
+		fprintf(stderr, "spillhl: nothing was spilled\n");
+		return 1;
+	}
+
+	kbds_keyboardhandler(-1, NULL, 0, 0);
+	kbds_keyboardhandler(XK_slash, NULL, 0, 0);
+	kbds_keyboardhandler(XK_x, "x", 1, 0);
+	kbds_keyboardhandler(XK_Return, NULL, 0, 0);
+	#if INDEXED_SEARCH_PATCH
+	while (kbds_searchstep(64))
+		;
+	#endif // INDEXED_SEARCH_PATCH
+
+	for (n = 0, y = -term.histf; y < term.row; y++) {
+		line = TLINEABS(y);
+		for (x = 0; x < term.col; x++)
+			n += (line[x].mode & ATTR_HIGHLIGHT) != 0;
+	}
+	if (n != lines) {
+		fprintf(stderr, "spillhl: %d of %d matches highlighted\n", n, lines);
+		return 1;
+	}
+	#endif // KEYBOARDSELECT_PATCH && REFLOW_PATCH && SCROLLBACK_SPILL_PATCH
+	return 0;
+}
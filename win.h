@@ -53,6 +53,9 @@ void xsetsel(char *);
 int xstartdraw(void);
 void xximspot(int, int);
 void xclearwin(void);
+#if SCROLL_BLIT_PATCH
+int xscroll(int, int, int);
+#endif // SCROLL_BLIT_PATCH
 #if REFLOW_PATCH && KEYBOARDSELECT_PATCH
 void xdrawglyph(Glyph, int, int);
 #endif // KEYBOARDSELECT_PATCH
\ No newline at end of file
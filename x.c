@@ -224,6 +224,13 @@ static char *opt_title = NULL;
 #if WORKINGDIR_PATCH
 static char *opt_dir   = NULL;
 #endif // WORKINGDIR_PATCH
+#if BENCHMARK_PATCH
+static char *opt_bench = NULL;
+#endif // BENCHMARK_PATCH
+#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+static char *opt_histsize = NULL;
+static char *opt_histmem = NULL;
+#endif // DYNAMIC_HISTORY_PATCH
 
 #if ALPHA_PATCH && ALPHA_FOCUS_HIGHLIGHT_PATCH
 static int focused = 0;
@@ -251,6 +258,11 @@ clipcopy(const Arg *dummy)
 {
 	Atom clipboard;
 
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
+
 	free(xsel.clipboard);
 	xsel.clipboard = NULL;
 
@@ -610,6 +622,11 @@ selnotify(XEvent *e)
 	}
 	#endif // DRAG_AND_DROP_PATCH
 
+	#if STREAMING_PASTE_PATCH
+	pastenotify(e, property);
+	return;
+	#endif // STREAMING_PASTE_PATCH
+
 	do {
 		if (XGetWindowProperty(xw.dpy, xw.win, property, ofs,
 					BUFSIZ/4, False, AnyPropertyType,
@@ -787,6 +804,10 @@ selrequest(XEvent *e)
 void
 setsel(char *str, Time t)
 {
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
 	if (!str)
 		return;
 
@@ -995,6 +1016,11 @@ xloadcols(void)
 	static int loaded;
 	Color *cp;
 
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
+
 	if (!loaded) {
 		dc.collen = 1 + (defaultbg = MAX(LEN(colorname), 256));
 		dc.col = xmalloc((dc.collen) * sizeof(Color));
@@ -1021,6 +1047,11 @@ xloadcols(void)
 	static int loaded;
 	Color *cp;
 
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
+
 	if (loaded) {
 		for (cp = dc.col; cp < &dc.col[dc.collen]; ++cp)
 			XftColorFree(xw.dpy, xw.vis, xw.cmap, cp);
@@ -1066,6 +1097,10 @@ xloadcols(void)
 int
 xgetcolor(int x, unsigned char *r, unsigned char *g, unsigned char *b)
 {
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return 1;
+	#endif // BENCHMARK_PATCH
 	if (!BETWEEN(x, 0, dc.collen - 1))
 		return 1;
 
@@ -1081,6 +1116,11 @@ xsetcolorname(int x, const char *name)
 {
 	Color ncolor;
 
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return 1;
+	#endif // BENCHMARK_PATCH
+
 	if (!BETWEEN(x, 0, dc.collen - 1))
 		return 1;
 
@@ -2944,6 +2984,12 @@ void
 xseticontitle(char *p)
 {
 	XTextProperty prop;
+
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
+
 	DEFAULT(p, opt_title);
 
 	if (p[0] == '\0')
@@ -2963,6 +3009,11 @@ xsettitle(char *p, int pop)
 {
 	XTextProperty prop;
 
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
+
 	free(titlestack[tstki]);
 	if (pop) {
 		titlestack[tstki] = NULL;
@@ -3006,6 +3057,12 @@ void
 xsettitle(char *p)
 {
 	XTextProperty prop;
+
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
+
 	DEFAULT(p, opt_title);
 
 	if (p[0] == '\0')
@@ -3414,6 +3471,10 @@ unmap(XEvent *ev)
 void
 xsetpointermotion(int set)
 {
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
 	#if HIDECURSOR_PATCH
 	if (!set && !xw.pointerisvisible)
 		return;
@@ -3430,6 +3491,10 @@ xsetmode(int set, unsigned int flags)
 {
 	int mode = win.mode;
 	MODBIT(win.mode, set, flags);
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
 	#if SWAPMOUSE_PATCH
 	if ((flags & MODE_MOUSE)
 	#if HIDECURSOR_PATCH
@@ -3492,6 +3557,10 @@ xseturgency(int add)
 void
 xbell(void)
 {
+	#if BENCHMARK_PATCH
+	if (!xw.dpy)
+		return;
+	#endif // BENCHMARK_PATCH
 	if (!(IS_SET(MODE_FOCUSED)))
 		xseturgency(1);
 	if (bellvolume)
@@ -3678,6 +3747,9 @@ kpress(XEvent *ev)
 
 	/* 2. custom keys from config.h */
 	if ((customkey = kmap(ksym, e->state))) {
+		#if STREAMING_PASTE_PATCH
+		pastecancel();
+		#endif // STREAMING_PASTE_PATCH
 		ttywrite(customkey, strlen(customkey), 1);
 		return;
 	}
@@ -3697,6 +3769,10 @@ kpress(XEvent *ev)
 			len = 2;
 		}
 	}
+	#if STREAMING_PASTE_PATCH
+	/* typing cuts the paste short rather than wait for it */
+	pastecancel();
+	#endif // STREAMING_PASTE_PATCH
 	ttywrite(buf, len, 1);
 }
 
@@ -3752,8 +3828,13 @@ resize(XEvent *e)
 		updatexy();
 	} else
 	#endif // BACKGROUND_IMAGE_PATCH
-	if (e->xconfigure.width == win.w && e->xconfigure.height == win.h)
+	if (e->xconfigure.width == win.w && e->xconfigure.height == win.h) {
+		#if COALESCE_RESIZE_PATCH
+		/* back to the size we have, forget about the last one */
+		resizecancel();
+		#endif // COALESCE_RESIZE_PATCH
 		return;
+	}
 
 	#if ST_EMBEDDER_PATCH
 	if (embed) {
@@ -3763,7 +3844,11 @@ resize(XEvent *e)
 	}
 	#endif // ST_EMBEDDER_PATCH
 
+	#if COALESCE_RESIZE_PATCH
+	resizequeue(e->xconfigure.width, e->xconfigure.height);
+	#else
 	cresize(e->xconfigure.width, e->xconfigure.height);
+	#endif // COALESCE_RESIZE_PATCH
 }
 
 void
@@ -3773,8 +3858,18 @@ run(void)
 	int w = win.w, h = win.h;
 	fd_set rfd;
 	int xfd = XConnectionNumber(xw.dpy), ttyfd, xev, drawing;
+	#if TTY_WRITEQUEUE_PATCH
+	fd_set wfd;
+	int ttywfd;
+	#endif // TTY_WRITEQUEUE_PATCH
 	struct timespec seltv, *tv, now, lastblink, trigger;
 	double timeout;
+	#if COALESCE_RESIZE_PATCH
+	double rtimeout;
+	#endif // COALESCE_RESIZE_PATCH
+	#if STREAMING_PASTE_PATCH
+	double ptimeout;
+	#endif // STREAMING_PASTE_PATCH
 
 	/* Waiting for window mapping */
 	do {
@@ -3793,12 +3888,26 @@ run(void)
 	} while (ev.type != MapNotify);
 
 	ttyfd = ttynew(opt_line, shell, opt_io, opt_cmd);
+	#if TTY_WRITEQUEUE_PATCH
+	ttywfd = ttyfd;
+	#endif // TTY_WRITEQUEUE_PATCH
+	#if TTY_THREAD_PATCH
+	ttyfd = ttythread();
+	#endif // TTY_THREAD_PATCH
 	cresize(w, h);
 
 	for (timeout = -1, drawing = 0, lastblink = (struct timespec){0};;) {
+		#if STREAMING_PASTE_PATCH
+		pasteresume();
+		#endif // STREAMING_PASTE_PATCH
 		FD_ZERO(&rfd);
 		FD_SET(ttyfd, &rfd);
 		FD_SET(xfd, &rfd);
+		#if TTY_WRITEQUEUE_PATCH
+		FD_ZERO(&wfd);
+		if (ttywritepending())
+			FD_SET(ttywfd, &wfd);
+		#endif // TTY_WRITEQUEUE_PATCH
 
 		#if SYNC_PATCH
 		if (XPending(xw.dpy) || ttyread_pending())
@@ -3811,13 +3920,23 @@ run(void)
 		seltv.tv_nsec = 1E6 * (timeout - 1E3 * seltv.tv_sec);
 		tv = timeout >= 0 ? &seltv : NULL;
 
-		if (pselect(MAX(xfd, ttyfd)+1, &rfd, NULL, NULL, tv, NULL) < 0) {
+		#if TTY_WRITEQUEUE_PATCH
+		if (pselect(MAX(MAX(xfd, ttyfd), ttywfd)+1, &rfd, &wfd, NULL, tv, NULL) < 0)
+		#else
+		if (pselect(MAX(xfd, ttyfd)+1, &rfd, NULL, NULL, tv, NULL) < 0)
+		#endif // TTY_WRITEQUEUE_PATCH
+		{
 			if (errno == EINTR)
 				continue;
 			die("select failed: %s\n", strerror(errno));
 		}
 		clock_gettime(CLOCK_MONOTONIC, &now);
 
+		#if TTY_WRITEQUEUE_PATCH
+		if (FD_ISSET(ttywfd, &wfd))
+			ttyflush();
+		#endif // TTY_WRITEQUEUE_PATCH
+
 		#if SYNC_PATCH
 		int ttyin = FD_ISSET(ttyfd, &rfd) || ttyread_pending();
 		if (ttyin)
@@ -3837,9 +3956,22 @@ run(void)
 			#endif // BLINKING_CURSOR_PATCH
 			if (XFilterEvent(&ev, None))
 				continue;
+			#if STREAMING_PASTE_PATCH
+			if (pasteownerevent(&ev))
+				continue;
+			#endif // STREAMING_PASTE_PATCH
 			if (handler[ev.type])
 				(handler[ev.type])(&ev);
 		}
+		#if STREAMING_PASTE_PATCH
+		pasteexpire(now);
+		#endif // STREAMING_PASTE_PATCH
+
+		#if COALESCE_RESIZE_PATCH
+		/* the window size has settled, draw at the new size */
+		if (resizeflush(now) && !xev)
+			xev = ConfigureNotify;
+		#endif // COALESCE_RESIZE_PATCH
 
 		/*
 		 * To reduce flicker and tearing, when new content or event
@@ -3874,6 +4006,22 @@ run(void)
 				continue;  /* we have time, try to find idle */
 		}
 
+		#if REFLOW_PATCH && INCREMENTAL_REFLOW_PATCH
+		/* nothing to draw, reflow more of the history */
+		if (!drawing && treflowstep(reflowslice)) {
+			timeout = 0;
+			continue;
+		}
+		#endif // INCREMENTAL_REFLOW_PATCH
+
+		#if KEYBOARDSELECT_PATCH && REFLOW_PATCH && INDEXED_SEARCH_PATCH
+		/* nothing to draw, highlight more search matches */
+		if (!drawing && kbds_searchstep(searchslice)) {
+			timeout = 0;
+			continue;
+		}
+		#endif // INDEXED_SEARCH_PATCH
+
 		#if SYNC_PATCH
 		if (tinsync(su_timeout)) {
 			/*
@@ -3921,17 +4069,58 @@ run(void)
 		#endif // VISUALBELL_1_PATCH
 		XFlush(xw.dpy);
 		drawing = 0;
+		#if REFLOW_PATCH && INCREMENTAL_REFLOW_PATCH
+		if (treflowpending())
+			timeout = 0;
+		#endif // INCREMENTAL_REFLOW_PATCH
+		#if KEYBOARDSELECT_PATCH && REFLOW_PATCH && INDEXED_SEARCH_PATCH
+		if (kbds_searchpending())
+			timeout = 0;
+		#endif // INDEXED_SEARCH_PATCH
+		#if COALESCE_RESIZE_PATCH
+		/* wake up when the pending resize is due */
+		rtimeout = resizetimeout(now);
+		if (rtimeout >= 0 && (timeout < 0 || rtimeout < timeout))
+			timeout = rtimeout;
+		#endif // COALESCE_RESIZE_PATCH
+		#if STREAMING_PASTE_PATCH
+		/* wake up when a stalled paste is to be given up on */
+		ptimeout = pastetimeleft(now);
+		if (ptimeout >= 0 && (timeout < 0 || ptimeout < timeout))
+			timeout = ptimeout;
+		#endif // STREAMING_PASTE_PATCH
 	}
 }
 
+#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+/*
+ * Applies the -H and -M options, which take precedence over the resources.
+ */
+static void
+histoptions(void)
+{
+	if (opt_histsize)
+		histsize = strtoul(opt_histsize, NULL, 10);
+	if (opt_histmem)
+		histmemory = strtoul(opt_histmem, NULL, 10);
+}
+#endif // DYNAMIC_HISTORY_PATCH
+
 void
 usage(void)
 {
-	die("usage: %s [-aiv] [-c class]"
+	die("usage: %s [-aiv]"
+		#if BENCHMARK_PATCH
+		" [-B file]"
+		#endif // BENCHMARK_PATCH
+		" [-c class]"
 		#if WORKINGDIR_PATCH
 		" [-d path]"
 		#endif // WORKINGDIR_PATCH
 		" [-f font] [-g geometry]"
+		#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+		" [-H lines] [-M MiB]"
+		#endif // DYNAMIC_HISTORY_PATCH
 		" [-n name] [-o file]\n"
 		"          [-T title] [-t title] [-w windowid]"
 		" [[-e] command [args ...]]\n"
@@ -3940,6 +4129,9 @@ usage(void)
 		" [-d path]"
 		#endif // WORKINGDIR_PATCH
 		" [-f font] [-g geometry]"
+		#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+		" [-H lines] [-M MiB]"
+		#endif // DYNAMIC_HISTORY_PATCH
 		" [-n name] [-o file]\n"
 		"          [-T title] [-t title] [-w windowid] -l line"
 		" [stty_args ...]\n", argv0, argv0);
@@ -3965,6 +4157,11 @@ main(int argc, char *argv[])
 		opt_alpha = EARGF(usage());
 		break;
 	#endif // ALPHA_PATCH
+	#if BENCHMARK_PATCH
+	case 'B':
+		opt_bench = EARGF(usage());
+		break;
+	#endif // BENCHMARK_PATCH
 	case 'c':
 		opt_class = EARGF(usage());
 		break;
@@ -3994,6 +4191,11 @@ main(int argc, char *argv[])
 		geometry = PixelGeometry;
 		break;
 	#endif // ANYGEOMETRY_PATCH
+	#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+	case 'H':
+		opt_histsize = EARGF(usage());
+		break;
+	#endif // DYNAMIC_HISTORY_PATCH
 	case 'i':
 		xw.isfixed = 1;
 		break;
@@ -4003,6 +4205,11 @@ main(int argc, char *argv[])
 	case 'l':
 		opt_line = EARGF(usage());
 		break;
+	#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+	case 'M':
+		opt_histmem = EARGF(usage());
+		break;
+	#endif // DYNAMIC_HISTORY_PATCH
 	case 'n':
 		opt_name = EARGF(usage());
 		break;
@@ -4028,6 +4235,14 @@ run:
 		opt_title = (opt_line || !opt_cmd) ? "st" : opt_cmd[0];
 
 	setlocale(LC_CTYPE, "");
+	#if BENCHMARK_PATCH
+	if (opt_bench) {
+		#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+		histoptions();
+		#endif // DYNAMIC_HISTORY_PATCH
+		return benchmark(opt_bench, MAX(cols, 1), MAX(rows, 1));
+	}
+	#endif // BENCHMARK_PATCH
 	XSetLocaleModifiers("");
 	#if XRESOURCES_PATCH && XRESOURCES_RELOAD_PATCH || BACKGROUND_IMAGE_PATCH && BACKGROUND_IMAGE_RELOAD_PATCH
 	signal(SIGUSR1, sigusr1_reload);
@@ -4038,6 +4253,9 @@ run:
 
 	config_init(xw.dpy);
 	#endif // XRESOURCES_PATCH
+	#if REFLOW_PATCH && DYNAMIC_HISTORY_PATCH
+	histoptions();
+	#endif // DYNAMIC_HISTORY_PATCH
 	#if LIGATURES_PATCH
 	hbcreatebuffer();
 	#endif // LIGATURES_PATCH